@@ -154,10 +154,7 @@ void ADC_NextChannel(void)
 }
 
 /* ===================================== */
-#include "../stringmanager/stringmanager.h"
-
 uint16_t ADC_ReadVolts(const te_ADC_Pins adc);
-void ADC_Show(void);
 
 void ADC_Init(void)
 {
@@ -167,12 +164,6 @@ void ADC_Init(void)
 	ADC_PostInit();
 }
 
-void ADC_Run(void)
-{
-	ADC_NextChannel();
-	ADC_Show();
-}
-
 uint16_t ADC_ReadVolts(const te_ADC_Pins adc) 
 {
 	uint16_t tmpChannelValue = 0u;
@@ -191,12 +182,3 @@ uint16_t ADC_ReadVolts(const te_ADC_Pins adc)
 	}
 	return retValue;
 }
-
-void ADC_Show(void) 
-{
-	uint16_t tmpChannelValue = 0u;
-
-	GW_Read_ADC_ChannelValue(&tmpChannelValue, ADC_POT1);
-	STR_WriteNumberToLCD(LCD_LINE_2, 0, 4, STR_ALIGNMENT_RIGHT, STR_FILLING_NONE, tmpChannelValue);
-	STR_WriteNumberToLCD(LCD_LINE_2, 5, 4, STR_ALIGNMENT_RIGHT, STR_FILLING_NONE, ADC_ReadVolts(ADC_POT1));
-}
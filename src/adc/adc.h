@@ -48,8 +48,6 @@ extern void ADC_StateToConfig(const te_ADC_Pins adc, const uint8_t state);
 #define ADC_REF_EXT_VOLT 5000
 
 extern void ADC_Init(void);
-extern void ADC_Run(void);
 extern uint16_t ADC_ReadVolts(const te_ADC_Pins adc);
-extern void ADC_Show(void);
 
 #endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "buzzer.h"
 
 #include "../dio/dio.h"
+#include "../defines.h"
 
 static int8_t BuzzerActiveTime = 0u;
 static uint8_t BuzzerState = CP_OFF;
@@ -28,4 +29,16 @@ void BZ_Run(void)
         }
         BuzzerActiveTime--;
     }
+}
+
+uint8_t BZ_IsActive(void)
+{
+    uint8_t retVal = D_FALSE;
+
+    if(BuzzerState == CP_ON)
+    {
+        retVal = D_TRUE;
+    }
+
+    return retVal;
 }
\ No newline at end of file
@@ -6,5 +6,6 @@
 extern void BZ_Init(void);
 extern void BZ_Bip(const int8_t time);
 extern void BZ_Run(void);
+extern uint8_t BZ_IsActive(void);
 
 #endif
\ No newline at end of file
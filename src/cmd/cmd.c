@@ -1,4 +1,5 @@
 #include "cmd.h"
+#include "cmdquery.h"
 
 #include "../utils/utils.h"
 #include "../dio/dio.h"
@@ -7,294 +8,1049 @@
 #include "../defines.h"
 #include "../oled/oled.h"
 #include "../stepmotor/stepmotor.h"
+#include "../tasktimer/tasktimer.h"
+#include "../script/script.h"
+#include "../memaccess/memaccess.h"
+#include "../layout/layout.h"
+#include <avr/pgmspace.h>
 
 #define CMD_OLED_STOP_DRAWING_CMD 0u
 #define CMD_OLED_START_DRAWING_CMD 1u
 #define CMD_OLED_SEND_TWI_CMD 2u
 
-#define CMD_MOT_STEPS_TO_BE_DONE_ACTIVE_BITS 0x0FFF
+#define CMD_MOT_DIRECTION_CLOCKWISE 0u
+#define CMD_MOT_DIRECTION_COUNTERCLOCKWISE 1u
+#define CMD_MOT_DIRECTION_QUANTITY 2u
+
+#define CMD_HASH_MASK (CMD_HASH_TABLE_SIZE - 1u)
+
+#define CMD_BATCH_PASS_CHECK 0u
+#define CMD_BATCH_PASS_EXECUTE 1u
+#define CMD_BATCH_PASS_QUANTITY 2u
+
+/* Resources a command keeps busy after its handler returns */
+#define CMD_RESOURCE_MOTOR 0x01u
+#define CMD_RESOURCE_EEPROM 0x02u
+#define CMD_RESOURCE_BUZZER 0x04u
+#define CMD_RESOURCE_TWI 0x08u
+
+typedef struct
+{
+    uint8_t name[CMD_COMMAND_LENGTH];
+    tf_CMD_Handler handler;
+    tf_CMD_Handler check;
+    tf_JOB_Poll poll;
+    uint8_t schema[CMD_ARG_MAX_QUANTITY];
+    uint8_t flags;
+} ts_CMD_Descriptor;
+
+static const ts_CMD_Descriptor PROGMEM CmdDescriptors[CMD_COMMAND_QUANTITY] = {
+#define CMD_ENTRY(id, name, handler, check, poll, schema, flags) { name, handler, check, poll, schema, flags },
+#include "cmdlist.h"
+#undef CMD_ENTRY
+};
+
+/* Does not compile if hash table is too small for registered commands */
+typedef uint8_t CmdHashTableSizeCheck[(CMD_HASH_TABLE_SIZE > CMD_COMMAND_QUANTITY) ? 1 : -1];
+
+/* Command ids by name hash, open addressing with linear probing */
+static uint8_t CmdHashTable[CMD_HASH_TABLE_SIZE];
+
+static uint8_t CMD_Hash(const uint8_t name[]);
+static uint8_t CMD_FindCommand(const uint8_t name[]);
+static void CMD_DecodeArgs(const uint8_t schema[], const uint8_t body[], const uint8_t length, ts_CMD_Args *args, uint8_t *error);
+static void CMD_DecodeCommand(const uint8_t body[], const uint8_t length, ts_CMD_Descriptor *descriptor, ts_CMD_Args *args, uint8_t *error);
+static uint8_t CMD_IsBusyError(const uint8_t error);
+static uint8_t CMD_IsRoomForResponse(const ts_CMD_Descriptor *descriptor);
+static uint8_t CMD_Dispatch(const uint8_t body[], const uint8_t length, uint8_t error, const uint8_t broadcast,
+	const uint16_t rxStart, const uint16_t rxComplete, const uint8_t deferAllowed);
+static void CMD_DispatchQueue(void);
+static void CMD_ClaimResource(const uint8_t resource, const uint8_t busyError, uint8_t *error);
+
+static const uint8_t CmdStsTag[CMD_COMMAND_LENGTH] = {'S', 'T', 'S'};
+static const uint8_t CmdGetTag[CMD_COMMAND_LENGTH] = {'G', 'E', 'T'};
+static const uint8_t CmdMrdTag[CMD_COMMAND_LENGTH] = {'M', 'R', 'D'};
+#define CMD_ACCEPTED_TAG_LENGTH 5u
+static const uint8_t CmdAcceptedTag[CMD_ACCEPTED_TAG_LENGTH] = {'_', 'A', 'C', 'C', '_'};
+
+/* Status responses are complete frames in flash, see cmdstatus.h */
+#define CMD_STATUS_MAX_BODY_LENGTH 9u
 
 typedef struct
 {
-    uint8_t name[3];
-    uint8_t qnt;
-    uint8_t data[4];
-} ts_CMD_Command;
-
-static ts_CMD_Command CmdCommands[CMD_COMMAND_QUANTITY] = {
-    { "led", 2, {0, 0, 0, 0} },
-    { "lcd", 4, {0, 0, 0, 0} },
-    { "bip", 1, {0, 0, 0, 0} },
-    { "old", 4, {0, 0, 0, 0} },
-    { "mot", 4, {0, 0, 0, 0} },
+	const uint8_t *frame;
+	uint8_t length;
+} ts_CMD_StatusFrame;
+
+#define CMD_STATUS(error, length, body) \
+	static const uint8_t PROGMEM CmdStatusFrame_##error[] = UART_CMD_FLASH_FRAME(length, body); \
+	typedef uint8_t CmdStatusLengthCheck_##error[((sizeof(body) - 1u) == 0x##length) && ((sizeof(body) - 1u) <= CMD_STATUS_MAX_BODY_LENGTH) ? 1 : -1];
+#include "cmdstatus.h"
+#undef CMD_STATUS
+
+/* Indexed by error code */
+static const ts_CMD_StatusFrame PROGMEM CmdStatusFrames[] = {
+#define CMD_STATUS(error, length, body) [error] = { CmdStatusFrame_##error, sizeof(CmdStatusFrame_##error) - 1u },
+#include "cmdstatus.h"
+#undef CMD_STATUS
 };
+#define CMD_STATUS_QUANTITY (sizeof(CmdStatusFrames) / sizeof(ts_CMD_StatusFrame))
+
+static const uint8_t PROGMEM CmdUnknownStatusFrame[] = UART_CMD_FLASH_FRAME(06, "_NTEX_");
+
+/* Commands that answer with data instead of status fill this body */
+static uint8_t CmdResponseBody[UART_MAX_BODY_LENGTH];
+static uint8_t CmdResponseLength = 0u;
+/* Request body starting with '@' asks for timestamps, the response body
+   gets '@' and rx start, rx complete, dispatch and enqueue times appended,
+   each as 4 hex digits in TT_TIMESTAMP_TICK_US units. The mark goes in
+   front of the command name, where no command can have it, so string
+   arguments may end with any character */
+#define CMD_TIMESTAMP_MARK '@'
+#define CMD_TIMESTAMP_MARK_LENGTH 1u
+#define CMD_TIMESTAMP_RX_START 0u
+#define CMD_TIMESTAMP_RX_COMPLETE 1u
+#define CMD_TIMESTAMP_DISPATCH 2u
+#define CMD_TIMESTAMP_ENQUEUE 3u
+#define CMD_TIMESTAMP_QUANTITY 4u
+#define CMD_TIMESTAMP_LENGTH (1u + (CMD_TIMESTAMP_QUANTITY * STR_16BIT_STRING_LENGTH))
 
-static uint8_t CmdCurrentCommand = CMD_EMPTY;
+static uint8_t CmdTimestampRequested = D_FALSE;
+static uint16_t CmdTimestamps[CMD_TIMESTAMP_QUANTITY] = {0u};
+
+/* Responses are not sent while broadcast frames are handled */
+static uint8_t CmdResponsesMuted = D_FALSE;
+
+/* Resources claimed by the checks since the command started, so the check
+   pass of a batch sees the resources taken by its earlier sub-commands */
+static uint8_t CmdClaimedResources = 0u;
+
+typedef struct
+{
+	uint8_t body[UART_MAX_BODY_LENGTH];
+	uint8_t length;
+	uint8_t priority;
+	uint8_t broadcast;
+	uint8_t retries;
+	uint16_t rxStart;
+	uint16_t rxComplete;
+} ts_CMD_QueueEntry;
+
+static ts_CMD_QueueEntry CmdQueue[CMD_QUEUE_SIZE];
+/* Queue slots in order of arrival, the first CmdQueueLength are used */
+static uint8_t CmdQueueOrder[CMD_QUEUE_SIZE];
+static uint8_t CmdQueueLength = 0u;
+
+#ifdef CMD_RESPONSE_COALESCING
+#define CMD_COALESCED_TAG_LENGTH 3u
+/* Record header: command name, status and data length */
+#define CMD_RECORD_HEADER_LENGTH (CMD_COMMAND_LENGTH + STR_8BIT_STRING_LENGTH + STR_8BIT_STRING_LENGTH)
+
+static const uint8_t CmdCoalescedTag[CMD_COALESCED_TAG_LENGTH] = {'M', 'R', 'F'};
+static const uint8_t CmdUnknownName[CMD_COMMAND_LENGTH] = {'?', '?', '?'};
+static uint8_t CmdCoalescedBody[UART_MAX_BODY_LENGTH];
+static uint8_t CmdCoalescedLength = 0u;
+#endif
 
 extern ts_SM_Motor SM_motor;
 
 void CMD_Init(void)
 {
+	uint8_t commandIdx = 0u;
+	uint8_t slot = 0u;
+	uint8_t name[CMD_COMMAND_LENGTH];
+
+	for(slot = 0u; slot < CMD_HASH_TABLE_SIZE; slot++)
+	{
+		CmdHashTable[slot] = CMD_EMPTY;
+	}
+	/* Table is bigger than number of commands, so free slot is always found */
+	for(commandIdx = 0u; commandIdx < CMD_COMMAND_QUANTITY; commandIdx++)
+	{
+		memcpy_P(name, CmdDescriptors[commandIdx].name, CMD_COMMAND_LENGTH);
+		slot = CMD_Hash(name);
+		while(CmdHashTable[slot] != CMD_EMPTY)
+		{
+			slot = (slot + 1u) & CMD_HASH_MASK;
+		}
+		CmdHashTable[slot] = commandIdx;
+	}
+	for(slot = 0u; slot < CMD_QUEUE_SIZE; slot++)
+	{
+		CmdQueueOrder[slot] = slot;
+	}
+	CmdQueueLength = 0u;
+}
+
+uint8_t CMD_Hash(const uint8_t name[])
+{
+	return (uint8_t)( (name[0] * 7u) ^ (name[1] * 3u) ^ name[2] ) & CMD_HASH_MASK;
+}
+
+uint8_t CMD_FindCommand(const uint8_t name[])
+{
+	uint8_t retVal = CMD_EMPTY;
+	uint8_t slot = 0u;
+	uint8_t probeCnt = 0u;
+	uint8_t commandIdx = 0u;
 
+	/* Probing stops at the first free slot */
+	slot = CMD_Hash(name);
+	for(probeCnt = 0u; (retVal == CMD_EMPTY) && (probeCnt < CMD_HASH_TABLE_SIZE) && (CmdHashTable[slot] != CMD_EMPTY); probeCnt++)
+	{
+		commandIdx = CmdHashTable[slot];
+		if( (pgm_read_byte(&CmdDescriptors[commandIdx].name[0]) == name[0]) &&
+			(pgm_read_byte(&CmdDescriptors[commandIdx].name[1]) == name[1]) &&
+			(pgm_read_byte(&CmdDescriptors[commandIdx].name[2]) == name[2]) )
+		{
+			retVal = commandIdx;
+		}
+		slot = (slot + 1u) & CMD_HASH_MASK;
+	}
+
+	return retVal;
 }
 
-void CMD_ExecMotCommand(uint8_t *error)
+void CMD_DecodeArgs(const uint8_t schema[], const uint8_t body[], const uint8_t length, ts_CMD_Args *args, uint8_t *error)
 {
-	uint8_t directionId = 0u;
-	uint16_t stepsToBeDone = 0u;
+	uint8_t argIdx = 0u;
+	uint8_t position = 0u;
+	uint8_t type = CMD_ARG_NONE;
+	uint8_t size = 0u;
 
-	if(SM_motor.stepsToBeDone <= 0)
+	for(argIdx = 0u; (argIdx < CMD_ARG_MAX_QUANTITY) && ((*error) == ERR_NO_ERROR); argIdx++)
 	{
-		directionId = STR_CharToHexDigit(CmdCommands[CmdCurrentCommand].data[0], error);
-		if( (*error) == ERR_NO_ERROR )
+		type = schema[argIdx] & CMD_ARG_TYPE_MASK;
+		size = schema[argIdx] & CMD_ARG_SIZE_MASK;
+		args->arg[argIdx].value = 0u;
+		args->arg[argIdx].string = &body[position];
+		args->arg[argIdx].length = 0u;
+		if(type == CMD_ARG_NONE)
 		{
-			stepsToBeDone = STR_StringTo16BitHex(&CmdCommands[CmdCurrentCommand].data[0], error);
-			stepsToBeDone &= CMD_MOT_STEPS_TO_BE_DONE_ACTIVE_BITS;
-			if( (*error) == ERR_NO_ERROR )
+			/* Schema is shorter than CMD_ARG_MAX_QUANTITY */
+			argIdx = CMD_ARG_MAX_QUANTITY;
+		} else
+		{
+			if(type == CMD_ARG_TYPE_ENUM)
 			{
-				if(directionId == 0u)
-				{
-					SM_motor.direction = SM_CLOCKWISE;
-				} else 
-				if(directionId == 1u)
+				/* Low nibble of enum is its quantity of values, not size */
+				size = 1u;
+			} else
+			if( (type == CMD_ARG_TYPE_STRING) && (size == 0u) && (length > position) )
+			{
+				size = length - position;
+			}
+			if( (size == 0u) || (size > (length - position)) )
+			{
+				(*error) = ERR_CMD_WRONG_ARG_LENGTH;
+			} else
+			{
+				args->arg[argIdx].length = size;
+				if(type == CMD_ARG_TYPE_HEX)
 				{
-					SM_motor.direction = SM_COUNTERCLOCKWISE;
+					args->arg[argIdx].value = STR_StringToHex(&body[position], size, error);
 				} else
+				if(type == CMD_ARG_TYPE_ENUM)
 				{
-					(*error) = ERR_CMD_MOT_WRONG_DIRECTION_ID;
-				}
-				if( (*error) == ERR_NO_ERROR )
+					args->arg[argIdx].value = STR_CharToHexDigit(body[position], error);
+					if( ((*error) == ERR_NO_ERROR) && (args->arg[argIdx].value >= (schema[argIdx] & CMD_ARG_SIZE_MASK)) )
+					{
+						(*error) = ERR_CMD_ARG_OUT_OF_RANGE;
+					}
+				} else
 				{
-					SM_motor.stepsToBeDone = (int16_t)stepsToBeDone;
+					/* String is passed as is */
 				}
+				position += size;
 			}
 		}
+	}
+	/* Nothing may follow the last argument */
+	if( ((*error) == ERR_NO_ERROR) && (position != length) )
+	{
+		(*error) = ERR_CMD_WRONG_ARG_LENGTH;
+	}
+}
+
+void CMD_DecodeCommand(const uint8_t body[], const uint8_t length, ts_CMD_Descriptor *descriptor, ts_CMD_Args *args, uint8_t *error)
+{
+	uint8_t commandIdx = CMD_EMPTY;
+
+	if(length >= CMD_COMMAND_LENGTH)
+	{
+		commandIdx = CMD_FindCommand(body);
+	}
+	if(commandIdx == CMD_EMPTY)
+	{
+		(*error) = ERR_CMD_COMMAND_NOT_FOUND;
 	} else
+	{
+		memcpy_P(descriptor, &CmdDescriptors[commandIdx], sizeof(ts_CMD_Descriptor));
+		/* Frame of the dispatched command, queued commands are not the last received ones */
+		if( ((descriptor->flags & CMD_FLAG_NO_BROADCAST) != 0u) && (CmdResponsesMuted == D_TRUE) )
+		{
+			(*error) = ERR_CMD_NO_BROADCAST;
+		} else
+		{
+			CMD_DecodeArgs(descriptor->schema, &body[CMD_COMMAND_LENGTH], length - CMD_COMMAND_LENGTH, args, error);
+		}
+	}
+}
+
+void CMD_Execute(const uint8_t body[], const uint8_t length, uint8_t *error)
+{
+	ts_CMD_Descriptor descriptor;
+	ts_CMD_Args args;
+
+	CMD_DecodeCommand(body, length, &descriptor, &args, error);
+	if( (*error) == ERR_NO_ERROR)
+	{
+		DIO_TogglePin(LED_7);
+		CmdClaimedResources = 0u;
+		descriptor.handler(&args, error);
+	}
+}
+
+void CMD_ClaimResource(const uint8_t resource, const uint8_t busyError, uint8_t *error)
+{
+	if((CmdClaimedResources & resource) != 0u)
+	{
+		(*error) = busyError;
+	} else
+	{
+		CmdClaimedResources |= resource;
+	}
+}
+
+void CMD_CheckNothing(const ts_CMD_Args *args, uint8_t *error)
+{
+	/* Command has nothing to check before it is executed */
+}
+
+uint8_t CMD_NoJob(uint8_t *error)
+{
+	/* Command is done when its handler returns */
+	return D_TRUE;
+}
+
+uint8_t CMD_PollMotCommand(uint8_t *error)
+{
+	return (SM_motor.stepsToBeDone == 0u) ? D_TRUE : D_FALSE;
+}
+
+uint8_t CMD_PollBipCommand(uint8_t *error)
+{
+	return (BZ_IsActive() == D_TRUE) ? D_FALSE : D_TRUE;
+}
+
+uint8_t CMD_PollOLEDCommand(uint8_t *error)
+{
+	return OLED_IsSettled(error);
+}
+
+void CMD_CheckMotCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	if(SM_motor.stepsToBeDone != 0u)
 	{
 		(*error) = ERR_CMD_MOT_IS_BUSY;
+	} else
+	{
+		CMD_ClaimResource(CMD_RESOURCE_MOTOR, ERR_CMD_MOT_IS_BUSY, error);
+	}
+}
+
+//ASK08mot10100END
+void CMD_ExecMotCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	CMD_CheckMotCommand(args, error);
+	if( (*error) == ERR_NO_ERROR)
+	{
+		if(args->arg[0].value == CMD_MOT_DIRECTION_CLOCKWISE)
+		{
+			SM_motor.direction = SM_CLOCKWISE;
+		} else
+		{
+			SM_motor.direction = SM_COUNTERCLOCKWISE;
+		}
+		SM_motor.stepsToBeDone = (uint16_t)args->arg[1].value;
+	}
+}
+
+void CMD_CheckLedCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	if(args->arg[0].value > 2u)
+	{
+		(*error) = ERR_CMD_LED_WRONG_LED_ID;
+	} else
+	if(args->arg[1].value > 1u)
+	{
+		(*error) = ERR_CMD_LED_WRONG_LED_STATE;
+	} else
+	{
+		/* Nothing to do */
 	}
 }
 
 //ASK05led01END
-void CMD_ExecLedCommand(uint8_t *error)
+void CMD_ExecLedCommand(const ts_CMD_Args *args, uint8_t *error)
 {
-	uint8_t ledId = 0u;
-	uint8_t ledState = 0u;
 	te_DIO_Pins ledDio = 0u;
 
-	ledId = STR_CharToHexDigit(CmdCommands[CmdCurrentCommand].data[0], error);
-	ledState = STR_CharToHexDigit(CmdCommands[CmdCurrentCommand].data[1], error);
+	CMD_CheckLedCommand(args, error);
 	if( (*error) == ERR_NO_ERROR)
 	{
-		if( (ledId >= 0u) && (ledId <= 2u) )
+		ledDio = (uint8_t)args->arg[0].value + LED_0;
+		if(args->arg[1].value == 0u)
 		{
-			ledDio = ledId + LED_0;
-		
-			if(ledState == 0u)
-			{
-				DIO_PinOff(ledDio);
-			} else 
-			if(ledState == 1u)
-			{
-				DIO_PinOn(ledDio);
-			} else 
-			{
-				(*error) = ERR_CMD_LED_WRONG_LED_STATE;
-			}
+			DIO_PinOff(ledDio);
 		} else
 		{
-			(*error) = ERR_CMD_LED_WRONG_LED_ID;
+			DIO_PinOn(ledDio);
 		}
 	}
-	
-	CmdCurrentCommand = CMD_EMPTY;
 }
 
-//ASK07lcd0888END
-void CMD_ExecLCDCommand(uint8_t *error)
+void CMD_CheckLCDCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	if( (args->arg[1].value + args->arg[2].length) > LCD_LINE_LENGTH )
+	{
+		(*error) = ERR_CMD_LCD_WRONG_POSITION;
+	} else
+	if(args->arg[0].value > 1u)
+	{
+		(*error) = ERR_CMD_LCD_WRONG_LINE_ID;
+	} else
+	if(LAY_IsAreaFree((uint8_t)args->arg[0].value, (uint8_t)args->arg[1].value, args->arg[2].length) == D_FALSE)
+	{
+		/* The field would overwrite the text at its next update */
+		(*error) = ERR_CMD_LCD_FIELD_TAKEN;
+	} else
+	{
+		/* Nothing to do */
+	}
+}
+
+//ASK07lcd0888END, text is up to the end of the line
+void CMD_ExecLCDCommand(const ts_CMD_Args *args, uint8_t *error)
 {
-	uint8_t lineId = 0u;
-	uint8_t position = 0u;
 	uint8_t line = LCD_LINE_1;
 
-	lineId = STR_CharToHexDigit(CmdCommands[CmdCurrentCommand].data[0], error);
-	position = STR_CharToHexDigit(CmdCommands[CmdCurrentCommand].data[1], error);
+	CMD_CheckLCDCommand(args, error);
 	if( (*error) == ERR_NO_ERROR)
 	{
-		if( (position >= 0u) & (position < LCD_LINE_LENGTH) )
+		if(args->arg[0].value == 1u)
 		{
-			if(lineId == 0u)
+			line = LCD_LINE_2;
+		}
+		STR_WriteStringToLCD(line, (uint8_t)args->arg[1].value, args->arg[2].length, (const char*)args->arg[2].string);
+	}
+}
+
+void CMD_CheckBipCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	if(args->arg[0].value == 0u)
+	{
+		(*error) = ERR_CMD_BZ_WRONG_TIME;
+	} else
+	if(BZ_IsActive() == D_TRUE)
+	{
+		/* The second bip would cut the first one */
+		(*error) = ERR_CMD_BZ_IS_BUSY;
+	} else
+	{
+		CMD_ClaimResource(CMD_RESOURCE_BUZZER, ERR_CMD_BZ_IS_BUSY, error);
+	}
+}
+
+//ASK04bip3END
+void CMD_ExecBipCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	CMD_CheckBipCommand(args, error);
+	if( (*error) == ERR_NO_ERROR)
+	{
+		BZ_Bip((uint8_t)args->arg[0].value);
+	}
+}
+
+//ASK03stsEND
+void CMD_ExecStsCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	uint8_t counterIdx = 0u;
+
+	/* Response is STS followed by line error counters in hex:
+	   overruns, framing errors, parity errors, ring overflows, bad frames */
+	U_ArrCpy(CmdResponseBody, CmdStsTag, CMD_COMMAND_LENGTH);
+	CmdResponseLength = CMD_COMMAND_LENGTH;
+	for(counterIdx = 0u; counterIdx < UART_ERR_CNT_QUANTITY; counterIdx++)
+	{
+		STR_8BitHexToString(&CmdResponseBody[CmdResponseLength], UART_Get_ErrorCounter(counterIdx));
+		CmdResponseLength += STR_8BIT_STRING_LENGTH;
+	}
+}
+
+//ASK04get*END, ASK05get0CEND
+void CMD_ExecGetCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	/* Response is GET followed by ids and values of requested signals */
+	U_ArrCpy(CmdResponseBody, CmdGetTag, CMD_COMMAND_LENGTH);
+	CmdResponseLength = CMD_COMMAND_LENGTH;
+	CmdResponseLength += CMD_QuerySignals(args->arg[0].string, args->arg[0].length, &CmdResponseBody[CMD_COMMAND_LENGTH], UART_MAX_BODY_LENGTH - CMD_COMMAND_LENGTH, error);
+}
+
+void CMD_CheckMrdCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	if(args->arg[2].value > MEM_MAX_READ_LENGTH)
+	{
+		(*error) = ERR_CMD_RESPONSE_TOO_LONG;
+	} else
+	{
+		MEM_CheckAccess((uint8_t)args->arg[0].value, (uint16_t)args->arg[1].value, (uint8_t)args->arg[2].value, error);
+	}
+}
+
+//ASK0Amrd1001B01END
+void CMD_ExecMrdCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	uint8_t data[MEM_MAX_READ_LENGTH];
+	uint8_t count = (uint8_t)args->arg[2].value;
+
+	CMD_CheckMrdCommand(args, error);
+	if( (*error) == ERR_NO_ERROR)
+	{
+		MEM_Read((uint8_t)args->arg[0].value, (uint16_t)args->arg[1].value, data, count, error);
+	}
+	if( (*error) == ERR_NO_ERROR)
+	{
+		/* Response is MRD followed by 2 hex digits per byte */
+		U_ArrCpy(CmdResponseBody, CmdMrdTag, CMD_COMMAND_LENGTH);
+		CmdResponseLength = CMD_COMMAND_LENGTH;
+		STR_HexEncode(&CmdResponseBody[CmdResponseLength], data, count);
+		CmdResponseLength += count * STR_8BIT_STRING_LENGTH;
+	}
+}
+
+/* Decodes mwr data into dst, returns number of bytes */
+static uint8_t CMD_DecodeMwrData(const ts_CMD_Args *args, uint8_t dst[], uint8_t *error)
+{
+	uint8_t retVal = args->arg[2].length / STR_8BIT_STRING_LENGTH;
+
+	if( ((args->arg[2].length % STR_8BIT_STRING_LENGTH) != 0u) || (retVal > MEM_MAX_WRITE_LENGTH) )
+	{
+		(*error) = ERR_CMD_WRONG_ARG_LENGTH;
+	} else
+	{
+		STR_HexDecode(dst, args->arg[2].string, retVal, error);
+	}
+	if( (*error) == ERR_NO_ERROR)
+	{
+		MEM_CheckAccess((uint8_t)args->arg[0].value, (uint16_t)args->arg[1].value, retVal, error);
+	}
+
+	return retVal;
+}
+
+void CMD_CheckMwrCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	uint8_t data[MEM_MAX_WRITE_LENGTH];
+
+	(void)CMD_DecodeMwrData(args, data, error);
+	/* EEPROM is busy until MEM_Run has written all bytes */
+	if( ((*error) == ERR_NO_ERROR) && (args->arg[0].value == MEM_SPACE_EEPROM) )
+	{
+		CMD_ClaimResource(CMD_RESOURCE_EEPROM, ERR_MEM_BUSY, error);
+	}
+}
+
+//ASK0Amwr1001BFFEND
+void CMD_ExecMwrCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	uint8_t data[MEM_MAX_WRITE_LENGTH];
+	uint8_t count = CMD_DecodeMwrData(args, data, error);
+
+	if( (*error) == ERR_NO_ERROR)
+	{
+		MEM_Write((uint8_t)args->arg[0].value, (uint16_t)args->arg[1].value, data, count, error);
+	}
+}
+
+//ASK05adr02END
+void CMD_ExecAdrCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	/* New RS-485 node address, stored in EEPROM */
+	UART_Set_NodeAddress((uint8_t)args->arg[0].value, error);
+}
+
+void CMD_CheckOLEDCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	if(args->arg[0].value > CMD_OLED_SEND_TWI_CMD)
+	{
+		(*error) = ERR_CMD_OLED_WRONG_COMMAND_ID;
+	} else
+	if( (args->arg[0].value == CMD_OLED_SEND_TWI_CMD) && (args->arg[1].value > 1u) )
+	{
+		(*error) = ERR_CMD_OLED_WRONG_CONTROL_BYTE;
+	} else
+	{
+		CMD_ClaimResource(CMD_RESOURCE_TWI, ERR_CMD_TWI_IS_BUSY, error);
+	}
+}
+
+void CMD_ExecOLEDCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	uint8_t controlByte = OLED_CONTROL_BYTE_COMMAND;
+
+	CMD_CheckOLEDCommand(args, error);
+	if( (*error) == ERR_NO_ERROR)
+	{
+		switch (args->arg[0].value)
+		{
+		case CMD_OLED_STOP_DRAWING_CMD:
+			/* todo comannd can not work from first attempt */
+			OLED_StopDrawing(error);
+			break;
+		case CMD_OLED_START_DRAWING_CMD:
+			OLED_StartDrawing(error);
+			break;
+		default:
+			if(args->arg[1].value == 1u)
 			{
-				line = LCD_LINE_1;
-			} else
-			if(lineId == 1u)
+				controlByte = OLED_CONTROL_BYTE_DATA;
+			}
+			OLED_SendTwoByteSequenceSecured(controlByte, (uint8_t)args->arg[2].value, error);
+			break;
+		}
+	}
+	//ASK07old0800END
+	//ASK07old08AEEND
+}
+
+/* Body is a list of sub-commands, each is 2 hex digits of its length
+   followed by the sub-command itself.
+   All sub-commands are decoded and checked first, then executed in the
+   same run, so either all of them are applied or none. Sub-commands
+   claim the motor, buzzer, TWI and EEPROM in the check pass, so a batch
+   using one of them twice is refused as busy. Only failures that can not
+   be seen in advance (like a TWI still busy with drawing) break a batch
+   after it has started */
+//ASK10bat05led0104bip3END
+void CMD_ExecBatCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	uint8_t pass = 0u;
+	uint8_t position = 0u;
+	uint8_t subLength = 0u;
+	const uint8_t *body = args->arg[0].string;
+	ts_CMD_Descriptor descriptor;
+	ts_CMD_Args subArgs;
+
+	for(pass = 0u; (pass < CMD_BATCH_PASS_QUANTITY) && ((*error) == ERR_NO_ERROR); pass++)
+	{
+		/* Handlers check and claim again in the execute pass */
+		CmdClaimedResources = 0u;
+		for(position = 0u; (position < args->arg[0].length) && ((*error) == ERR_NO_ERROR); position += subLength)
+		{
+			subLength = 0u;
+			if( (args->arg[0].length - position) < STR_8BIT_STRING_LENGTH )
 			{
-				line = LCD_LINE_2;
+				(*error) = ERR_CMD_WRONG_ARG_LENGTH;
 			} else
 			{
-				(*error) = ERR_CMD_LCD_WRONG_LINE_ID;
+				subLength = STR_StringTo8BitHex(&body[position], error);
+				position += STR_8BIT_STRING_LENGTH;
+				if( ((*error) == ERR_NO_ERROR) && ( (subLength == 0u) || (subLength > (args->arg[0].length - position)) ) )
+				{
+					(*error) = ERR_CMD_WRONG_ARG_LENGTH;
+				}
+			}
+			if( (*error) == ERR_NO_ERROR)
+			{
+				CMD_DecodeCommand(&body[position], subLength, &descriptor, &subArgs, error);
+			}
+			if( ((*error) == ERR_NO_ERROR) && ((descriptor.flags & CMD_FLAG_NO_BATCH) != 0u) )
+			{
+				(*error) = ERR_CMD_NO_BATCH;
+			}
+			if( (*error) == ERR_NO_ERROR)
+			{
+				if(pass == CMD_BATCH_PASS_CHECK)
+				{
+					descriptor.check(&subArgs, error);
+				} else
+				{
+					descriptor.handler(&subArgs, error);
+				}
 			}
+		}
+	}
+}
+
+/* Takes enqueue time and writes '@' with all timestamps to dst */
+static uint8_t CMD_AppendTimestamps(uint8_t dst[])
+{
+	uint8_t stampIdx = 0u;
+	uint8_t retVal = 0u;
+
+	CmdTimestamps[CMD_TIMESTAMP_ENQUEUE] = TT_GetTimestamp();
+	dst[retVal] = CMD_TIMESTAMP_MARK;
+	retVal++;
+	for(stampIdx = 0u; stampIdx < CMD_TIMESTAMP_QUANTITY; stampIdx++)
+	{
+		STR_16BitHexToString(&dst[retVal], CmdTimestamps[stampIdx]);
+		retVal += STR_16BIT_STRING_LENGTH;
+	}
+
+	return retVal;
+}
+
+static void CMD_SendResponse(const uint8_t body[], const uint8_t length)
+{
+	uint8_t stampedBody[UART_MAX_BODY_LENGTH];
+	uint8_t stampedLength = length;
+
+	if( (CmdTimestampRequested == D_TRUE) && ( (length + CMD_TIMESTAMP_LENGTH) <= UART_MAX_BODY_LENGTH ) )
+	{
+		U_ArrCpy(stampedBody, body, length);
+		stampedLength += CMD_AppendTimestamps(&stampedBody[length]);
+		UART_TX_WritePackage(stampedBody, stampedLength);
+	} else
+	{
+		UART_TX_WritePackage(body, length);
+	}
+}
+
+void CMD_ResponcePackage(const uint8_t error)
+{
+	ts_CMD_StatusFrame status;
+	uint8_t body[CMD_STATUS_MAX_BODY_LENGTH];
+	uint8_t bodyLength = 0u;
+	uint8_t idx = 0u;
+
+	if(error < CMD_STATUS_QUANTITY)
+	{
+		memcpy_P(&status, &CmdStatusFrames[error], sizeof(ts_CMD_StatusFrame));
+	} else
+	{
+		status.frame = 0;
+	}
+	if(status.frame == 0)
+	{
+		status.frame = CmdUnknownStatusFrame;
+		status.length = sizeof(CmdUnknownStatusFrame) - 1u;
+	}
+	if(CmdTimestampRequested == D_TRUE)
+	{
+		/* Timestamps are appended to the body, so it is sent from RAM */
+		bodyLength = status.length - (UART_FRAME_HEADER_LENGTH + UART_STOP_SEQ_LENGTH);
+		for(idx = 0u; idx < bodyLength; idx++)
+		{
+			body[idx] = pgm_read_byte(&status.frame[UART_FRAME_HEADER_LENGTH + idx]);
+		}
+		CMD_SendResponse(body, bodyLength);
+	} else
+	{
+		(void)UART_TX_WriteFlashFrame(UART_CH_CMD, status.frame, status.length);
+	}
+}
+
+void CMD_Respond(const uint8_t recievedMessage[], const uint8_t length, const uint8_t error)
+{
+#ifdef CMD_RESPONSE_COALESCING
+	uint8_t dataLength = CmdResponseLength;
+
+	if(error != ERR_NO_ERROR)
+	{
+		dataLength = 0u;
+	}
+	if( (CmdTimestampRequested == D_TRUE) && ( (dataLength + CMD_TIMESTAMP_LENGTH) <= UART_MAX_BODY_LENGTH ) )
+	{
+		dataLength += CMD_AppendTimestamps(&CmdResponseBody[dataLength]);
+	}
+	/* Record data is cut if even alone it does not fit the frame */
+	if(dataLength > (UART_MAX_BODY_LENGTH - (CMD_COALESCED_TAG_LENGTH + CMD_RECORD_HEADER_LENGTH)) )
+	{
+		dataLength = UART_MAX_BODY_LENGTH - (CMD_COALESCED_TAG_LENGTH + CMD_RECORD_HEADER_LENGTH);
+	}
+	/* If record does not fit current frame, send what we have and start a new one */
+	if( (CmdCoalescedLength + CMD_RECORD_HEADER_LENGTH + dataLength) > UART_MAX_BODY_LENGTH )
+	{
+		CMD_FlushResponses();
+	}
+	if(CmdCoalescedLength == 0u)
+	{
+		U_ArrCpy(CmdCoalescedBody, CmdCoalescedTag, CMD_COALESCED_TAG_LENGTH);
+		CmdCoalescedLength = CMD_COALESCED_TAG_LENGTH;
+	}
+	/* Frame stays if the queue had no room for it, the record is lost then.
+	   CMD_IsRoomForResponse prevents it for every command that is executed */
+	if( (CmdCoalescedLength + CMD_RECORD_HEADER_LENGTH + dataLength) <= UART_MAX_BODY_LENGTH )
+	{
+		/* Record: command name, status and data length in hex, data */
+		if(length >= CMD_COMMAND_LENGTH)
+		{
+			U_ArrCpy(&CmdCoalescedBody[CmdCoalescedLength], recievedMessage, CMD_COMMAND_LENGTH);
 		} else
 		{
-			(*error) = ERR_CMD_LCD_WRONG_POSITION;
+			U_ArrCpy(&CmdCoalescedBody[CmdCoalescedLength], CmdUnknownName, CMD_COMMAND_LENGTH);
 		}
+		CmdCoalescedLength += CMD_COMMAND_LENGTH;
+		STR_8BitHexToString(&CmdCoalescedBody[CmdCoalescedLength], error);
+		CmdCoalescedLength += STR_8BIT_STRING_LENGTH;
+		STR_8BitHexToString(&CmdCoalescedBody[CmdCoalescedLength], dataLength);
+		CmdCoalescedLength += STR_8BIT_STRING_LENGTH;
+		U_ArrCpy(&CmdCoalescedBody[CmdCoalescedLength], CmdResponseBody, dataLength);
+		CmdCoalescedLength += dataLength;
 	}
-	
-	STR_WriteStringToLCD(line, position, 2, (char*)&CmdCommands[CmdCurrentCommand].data[2]);
+#else
+	if( (error == ERR_NO_ERROR) && (CmdResponseLength > 0u) )
+	{
+		CMD_SendResponse(CmdResponseBody, CmdResponseLength);
+	} else
+	{
+		CMD_ResponcePackage(error);
+	}
+#endif
 }
 
-//ASK04bip3END
-void CMD_ExecBipCommand(uint8_t *error)
+void CMD_FlushResponses(void)
 {
-	uint8_t time = 0u;
-	
-	time = STR_CharToHexDigit(CmdCommands[CmdCurrentCommand].data[0], error);
-	if( (*error) == ERR_NO_ERROR)
+#ifdef CMD_RESPONSE_COALESCING
+	/* Frame is kept for the next try if the queue has no room for it */
+	if( (CmdCoalescedLength > 0u) &&
+		(UART_TX_WriteChannelPackage(UART_CH_CMD, CmdCoalescedBody, CmdCoalescedLength) == D_TRUE) )
+	{
+		CmdCoalescedLength = 0u;
+	}
+#endif
+}
+
+uint8_t CMD_IsBusyError(const uint8_t error)
+{
+	uint8_t retVal = D_FALSE;
+
+	if( (error == ERR_CMD_MOT_IS_BUSY) || (error == ERR_CMD_TWI_IS_BUSY) ||
+		(error == ERR_SCR_BUSY) || (error == ERR_JOB_FULL) || (error == ERR_MEM_BUSY) ||
+		(error == ERR_CMD_TX_BUSY) || (error == ERR_CMD_BZ_IS_BUSY) )
 	{
-		if(time != 0u)
+		retVal = D_TRUE;
+	}
+
+	return retVal;
+}
+
+/* Tells if the longest answer of the command can be queued now, so
+   a command is never executed without sending its answer */
+uint8_t CMD_IsRoomForResponse(const ts_CMD_Descriptor *descriptor)
+{
+#ifdef CMD_RESPONSE_COALESCING
+	/* Status is in the record header */
+	uint8_t dataLength = 0u;
+#else
+	uint8_t dataLength = CMD_STATUS_MAX_BODY_LENGTH;
+#endif
+	uint8_t retVal = D_FALSE;
+
+	if( ((descriptor->flags & CMD_FLAG_DATA_RESPONSE) != 0u) || (descriptor->poll != CMD_NoJob) )
+	{
+		dataLength = UART_MAX_BODY_LENGTH;
+	}
+	if(CmdTimestampRequested == D_TRUE)
+	{
+		dataLength += CMD_TIMESTAMP_LENGTH;
+	}
+	if(dataLength > UART_MAX_BODY_LENGTH)
+	{
+		dataLength = UART_MAX_BODY_LENGTH;
+	}
+#ifdef CMD_RESPONSE_COALESCING
+	/* Record goes to the gathered frame, which is sent first if the record may not fit it */
+	if(dataLength > (UART_MAX_BODY_LENGTH - (CMD_COALESCED_TAG_LENGTH + CMD_RECORD_HEADER_LENGTH)) )
+	{
+		dataLength = UART_MAX_BODY_LENGTH - (CMD_COALESCED_TAG_LENGTH + CMD_RECORD_HEADER_LENGTH);
+	}
+	if( (CmdCoalescedLength + CMD_RECORD_HEADER_LENGTH + dataLength) > UART_MAX_BODY_LENGTH )
+	{
+		CMD_FlushResponses();
+	}
+	if( (CmdCoalescedLength + CMD_RECORD_HEADER_LENGTH + dataLength) <= UART_MAX_BODY_LENGTH )
+	{
+		retVal = D_TRUE;
+	}
+#else
+	retVal = UART_TX_IsRoomForPackage(UART_CH_CMD, dataLength);
+#endif
+
+	return retVal;
+}
+
+/* Length of the timestamp mark in front of the command, 0 if there is none */
+static uint8_t CMD_TimestampMarkLength(const uint8_t body[], const uint8_t length)
+{
+	uint8_t retVal = 0u;
+
+	if( (length > 0u) && (body[0] == CMD_TIMESTAMP_MARK) )
+	{
+		retVal = CMD_TIMESTAMP_MARK_LENGTH;
+	}
+
+	return retVal;
+}
+
+/* Executes and answers one command, returns D_FALSE if it is deferred */
+uint8_t CMD_Dispatch(const uint8_t body[], const uint8_t length, uint8_t error, const uint8_t broadcast,
+	const uint16_t rxStart, const uint16_t rxComplete, const uint8_t deferAllowed)
+{
+	uint8_t markLength = CMD_TimestampMarkLength(body, length);
+	const uint8_t *commandBody = &body[markLength];
+	uint8_t commandLength = length - markLength;
+	uint8_t asyncCommand = D_FALSE;
+	uint8_t retVal = D_TRUE;
+	ts_CMD_Descriptor descriptor;
+	ts_CMD_Args args;
+
+	CmdTimestamps[CMD_TIMESTAMP_RX_START] = rxStart;
+	CmdTimestamps[CMD_TIMESTAMP_RX_COMPLETE] = rxComplete;
+	CmdTimestamps[CMD_TIMESTAMP_DISPATCH] = TT_GetTimestamp();
+	CmdTimestampRequested = D_FALSE;
+	if(markLength > 0u)
+	{
+		CmdTimestampRequested = D_TRUE;
+	}
+	CmdResponseLength = 0u;
+	/* Broadcast frames are executed by every node, so nobody answers them */
+	CmdResponsesMuted = broadcast;
+	descriptor.flags = CMD_FLAG_NONE;
+	if(error == ERR_NO_ERROR)
+	{
+		if(commandLength > 0u)
 		{
-			BZ_Bip(time);
-		} else 
+			CMD_DecodeCommand(commandBody, commandLength, &descriptor, &args, &error);
+			if( (error == ERR_NO_ERROR) && (CmdResponsesMuted == D_FALSE) &&
+				(CMD_IsRoomForResponse(&descriptor) == D_FALSE) )
+			{
+				error = ERR_CMD_TX_BUSY;
+			}
+			/* Job is started only when somebody gets the accepted answer */
+			if( (error == ERR_NO_ERROR) && (descriptor.poll != CMD_NoJob) && (CmdResponsesMuted == D_FALSE) )
+			{
+				asyncCommand = D_TRUE;
+			}
+			if( (asyncCommand == D_TRUE) && (JOB_IsSlotFree() == D_FALSE) )
+			{
+				error = ERR_JOB_FULL;
+			}
+			if(error == ERR_NO_ERROR)
+			{
+				DIO_TogglePin(LED_7);
+				CmdClaimedResources = 0u;
+				descriptor.handler(&args, &error);
+			}
+			if( (error == ERR_NO_ERROR) && (asyncCommand == D_TRUE) )
+			{
+				U_ArrCpy(CmdResponseBody, CmdAcceptedTag, CMD_ACCEPTED_TAG_LENGTH);
+				STR_8BitHexToString(&CmdResponseBody[CMD_ACCEPTED_TAG_LENGTH], JOB_Start(descriptor.poll));
+				CmdResponseLength = CMD_ACCEPTED_TAG_LENGTH + JOB_ID_LENGTH;
+			}
+		} else
 		{
-			(*error) = ERR_CMD_BZ_WRONG_TIME;
+			error = ERR_CMD_CURROPTED_PACKAGE;
 		}
 	}
-	CmdCurrentCommand = CMD_EMPTY;
+	/* Full transmit queue is found before the handler, so any command can wait for it */
+	if( (deferAllowed == D_TRUE) && (CMD_IsBusyError(error) == D_TRUE) &&
+		( ((descriptor.flags & CMD_FLAG_DEFER_BUSY) != 0u) || (error == ERR_CMD_TX_BUSY) ) )
+	{
+		/* Nothing was changed by the command, it is retried later */
+		retVal = D_FALSE;
+	} else
+	if(CmdResponsesMuted == D_FALSE)
+	{
+		CMD_Respond(commandBody, commandLength, error);
+	} else
+	{
+		/* Nobody listens to broadcast */
+	}
+
+	return retVal;
 }
 
-void CMD_ExecOLEDCommand(uint8_t *error)
+void CMD_DispatchQueue(void)
 {
-	uint8_t commandId = 0u;
-	uint8_t dataByte = 0u;
-	uint8_t controlByteId = 0u;
-	uint8_t controlByte = OLED_CONTROL_BYTE_COMMAND;
+	uint8_t priority = CMD_PRIORITY_NORMAL;
+	uint8_t orderIdx = 0u;
+	uint8_t idx = 0u;
+	uint8_t slot = 0u;
+	ts_CMD_QueueEntry *entry;
 
-	commandId = STR_CharToHexDigit(CmdCommands[CmdCurrentCommand].data[0], error);
-	controlByteId = STR_CharToHexDigit(CmdCommands[CmdCurrentCommand].data[1], error);
-	if( (*error) == ERR_NO_ERROR)
+	for(priority = CMD_PRIORITY_NORMAL; priority < CMD_PRIORITY_QUANTITY; priority++)
 	{
-		dataByte = STR_StringTo8BitHex(&CmdCommands[CmdCurrentCommand].data[2], error);
-		if( (*error) == ERR_NO_ERROR)
+		orderIdx = 0u;
+		while(orderIdx < CmdQueueLength)
 		{
-			switch (commandId)
+			slot = CmdQueueOrder[orderIdx];
+			entry = &CmdQueue[slot];
+			if( (entry->priority == priority) &&
+				(CMD_Dispatch(entry->body, entry->length, ERR_NO_ERROR, entry->broadcast, entry->rxStart, entry->rxComplete,
+					(entry->retries < CMD_DEFER_MAX_RETRIES) ? D_TRUE : D_FALSE) == D_TRUE) )
 			{
-			case CMD_OLED_STOP_DRAWING_CMD:
-				/* todo comannd can not work from first attempt */
-				OLED_StopDrawing(error);
-				break;
-			case CMD_OLED_START_DRAWING_CMD:
-				OLED_StartDrawing(error);
-				break;
-			case CMD_OLED_SEND_TWI_CMD:
-				if(controlByteId == 0u)
-				{
-					controlByte = OLED_CONTROL_BYTE_COMMAND;
-				} else 
-				if(controlByteId == 1u)
+				/* Remove the command, its slot goes behind the used ones */
+				CmdQueueLength--;
+				for(idx = orderIdx; idx < CmdQueueLength; idx++)
 				{
-					controlByte = OLED_CONTROL_BYTE_DATA;
-				} else 
-				{
-					(*error) = ERR_CMD_OLED_WRONG_CONTROL_BYTE;
+					CmdQueueOrder[idx] = CmdQueueOrder[idx + 1u];
 				}
-				if( (*error) == ERR_NO_ERROR)
+				CmdQueueOrder[CmdQueueLength] = slot;
+			} else
+			{
+				if(entry->priority == priority)
 				{
-					OLED_SendTwoByteSequenceSecured(controlByte, dataByte, error);
+					entry->retries++;
 				}
-				break;
-			default:
-				(*error) = ERR_CMD_OLED_WRONG_COMMAND_ID;
-				break;
+				orderIdx++;
 			}
 		}
 	}
-	//STR_WriteStringToLCD(LCD_LINE_2, 5, 4, CmdCommands[CmdCurrentCommand].data);
-	//ASK07old0800END
-	//ASK07old08AEEND
-}
-
-void CMD_Execute(uint8_t *error)
-{
-	switch (CmdCurrentCommand)
-	{
-	case CMD_LED:
-		CMD_ExecLedCommand(error);
-		break;
-	case CMD_LCD:
-		CMD_ExecLCDCommand(error);
-		break;
-	case CMD_BIP:
-		CMD_ExecBipCommand(error);
-		break;
-	case CMD_OLD:
-		CMD_ExecOLEDCommand(error);
-		break;
-	case CMD_MOT:
-		CMD_ExecMotCommand(error);
-		break;
-	default:
-		(*error) = ERR_CMD_COMMAND_NOT_FOUND;
-		break;
-	}
+	CmdResponsesMuted = D_FALSE;
 }
 
-void CMD_ResponcePackage(const uint8_t error)
+void CMD_HandlePackage(const uint8_t recievedMessage[], const uint8_t length, uint8_t error)
 {
-	switch (error)
-	{
-	case ERR_NO_ERROR:
-		UART_TX_WritePackage((const uint8_t*)"_OK_", 4);
-		break;
-	case ERR_STR_WRONG_CHARACTER:
-		UART_TX_WritePackage((const uint8_t*)"_STRWRCR_", 9);
-		break;
-	case ERR_STR_WRONG_HEX_DIGIT:
-		UART_TX_WritePackage((const uint8_t*)"_STRSWHX_", 9);
-		break;
-	case ERR_CMD_COMMAND_NOT_FOUND:
-		UART_TX_WritePackage((const uint8_t*)"_CMDCMNF_", 9);
-		break;
-	case ERR_CMD_CURROPTED_PACKAGE:
-		UART_TX_WritePackage((const uint8_t*)"_CMDCRPG_", 9);
-		break;
-	case ERR_CMD_LED_WRONG_LED_ID:
-		UART_TX_WritePackage((const uint8_t*)"_LEDWLID_", 9);
-		break;
-	case ERR_CMD_LED_WRONG_LED_STATE:
-		UART_TX_WritePackage((const uint8_t*)"_LEDWLST_", 9);
-		break;
-	case ERR_CMD_LCD_WRONG_LINE_ID:
-		UART_TX_WritePackage((const uint8_t*)"_LCDWLID_", 9);
-		break;
-	case ERR_CMD_LCD_WRONG_POSITION:
-		UART_TX_WritePackage((const uint8_t*)"_LCDWPOS_", 9);
-		break;
-	case ERR_CMD_BZ_WRONG_TIME:
-		UART_TX_WritePackage((const uint8_t*)"_BUZWRTM_", 9);
-		break;
-	case ERR_CMD_OLED_WRONG_CONTROL_BYTE:
-		UART_TX_WritePackage((const uint8_t*)"_OLDWRCB_", 9);
-		break;
-	case ERR_CMD_OLED_WRONG_COMMAND_ID:
-		UART_TX_WritePackage((const uint8_t*)"_OLDWCID_", 9);
-		break;
-	case ERR_CMD_OLED_FAIL_TO_STOP:
-		UART_TX_WritePackage((const uint8_t*)"_OLDFSOP_", 9);
-		break;
-	case ERR_CMD_OLED_FAIL_TO_START:
-		UART_TX_WritePackage((const uint8_t*)"_OLDFSRT_", 9);
-		break;
-	case ERR_CMD_MOT_WRONG_DIRECTION_ID:
-		UART_TX_WritePackage((const uint8_t*)"_MOTWDID_", 9);
-		break;
-	case ERR_CMD_MOT_IS_BUSY:
-		UART_TX_WritePackage((const uint8_t*)"_MOTBUSY_", 9);
-	case ERR_CMD_TWI_IS_BUSY:
-		UART_TX_WritePackage((const uint8_t*)"_TWIBUSY_", 9);
-		break;
-	default:
-		UART_TX_WritePackage((const uint8_t*)"_NTEX_", 6);
-		break;
+	uint8_t commandIdx = CMD_EMPTY;
+	uint8_t markLength = 0u;
+	uint8_t broadcast = UART_RX_IsBroadcast();
+	uint16_t rxStart = 0u;
+	uint16_t rxComplete = 0u;
+	ts_CMD_QueueEntry *entry;
+
+	UART_RX_Get_PackageTimestamps(&rxStart, &rxComplete);
+	/* Room is made by dispatching waiting commands that can run now */
+	if( (error == ERR_NO_ERROR) && (CmdQueueLength == CMD_QUEUE_SIZE) )
+	{
+		CMD_DispatchQueue();
+	}
+	/* Broken frames are answered at once */
+	if( (error == ERR_NO_ERROR) && (CmdQueueLength < CMD_QUEUE_SIZE) )
+	{
+		entry = &CmdQueue[CmdQueueOrder[CmdQueueLength]];
+		U_ArrCpy(entry->body, recievedMessage, length);
+		entry->length = length;
+		entry->broadcast = broadcast;
+		entry->retries = 0u;
+		entry->rxStart = rxStart;
+		entry->rxComplete = rxComplete;
+		entry->priority = CMD_PRIORITY_NORMAL;
+		markLength = CMD_TimestampMarkLength(recievedMessage, length);
+		if(length >= (markLength + CMD_COMMAND_LENGTH))
+		{
+			commandIdx = CMD_FindCommand(&recievedMessage[markLength]);
+		}
+		if( (commandIdx != CMD_EMPTY) && ((pgm_read_byte(&CmdDescriptors[commandIdx].flags) & CMD_FLAG_LOW_PRIORITY) != 0u) )
+		{
+			entry->priority = CMD_PRIORITY_LOW;
+		}
+		CmdQueueLength++;
+	} else
+	{
+		(void)CMD_Dispatch(recievedMessage, length, error, broadcast, rxStart, rxComplete, D_FALSE);
+		CmdResponsesMuted = D_FALSE;
 	}
 }
 
@@ -304,50 +1060,25 @@ void CMD_Run(void)
 	/* ~22-360 us */
     uint8_t recievedMessage[UART_MAX_BODY_LENGTH] = {0};
 	uint8_t length = 0u;
-    uint8_t commandIdx = 0u;
 	uint16_t UART_RX_newDataLength = 0u;
 	uint8_t error = ERR_NO_ERROR;
 
 	UART_RX_newDataLength = UART_Get_RX_newDataLength();
-	if(UART_RX_newDataLength > 0u)
+	/* Every package received completely since the last run is handled now */
+	if( (UART_RX_newDataLength > 0u) && (UART_RX_FetchBuffer() > 0u) )
 	{
-		CmdCurrentCommand = CMD_EMPTY;
-		UART_RX_ReadPackage(recievedMessage, &length, &error);
-		if(error == ERR_NO_ERROR)
+		do
 		{
-			/*todo if*/
-			if(length > 0u)
-			{		
-				//STR_WriteStringToLCD(LCD_LINE_2, 5, length, recievedMessage);
-				for(commandIdx = 0u; commandIdx < CMD_COMMAND_QUANTITY;  commandIdx++)
-				{
-					if( (length == CMD_COMMAND_LENGTH + CmdCommands[commandIdx].qnt) && (U_ArrCmp(recievedMessage, CmdCommands[commandIdx].name, CMD_COMMAND_LENGTH) == 0) )
-					{
-						DIO_TogglePin(LED_7);	
-						U_ArrCpy(CmdCommands[commandIdx].data, &recievedMessage[CMD_COMMAND_LENGTH], CmdCommands[commandIdx].qnt);
-						CmdCurrentCommand = commandIdx;
-					}
-				}
-				if(CmdCurrentCommand == CMD_EMPTY)
-				{
-					CMD_ResponcePackage(ERR_CMD_COMMAND_NOT_FOUND);
-				} else
-				{
-					CMD_Execute(&error);
-					CMD_ResponcePackage(error);
-				}
-			} else
-			{
-				CMD_ResponcePackage(ERR_CMD_CURROPTED_PACKAGE);
-			}
-		} else 
-		{
-			CMD_ResponcePackage(error);
-		}
+			error = ERR_NO_ERROR;
+			UART_RX_ReadPackage(recievedMessage, &length, &error);
+			CMD_HandlePackage(recievedMessage, length, error);
+		} while(UART_RX_IsPackagePending() == D_TRUE);
 	}
+	/* Deferred commands are retried even if nothing new came */
+	CMD_DispatchQueue();
+	CMD_FlushResponses();
 	//DIO_PinOff(TIME_MEASURENMENT);
     //ASK04hellEND
 	//ASK09amstupid?END
     
 }
-
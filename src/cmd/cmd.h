@@ -2,22 +2,110 @@
 #define cmd_h
 
 #include "../uart/uart.h"
+#include "../job/job.h"
+
+/* Define CMD_RESPONSE_COALESCING to gather all responses of one CMD_Run
+   into a single frame: MRF followed by records of command name,
+   status (hex) and data length (hex) with data */
+//#define CMD_RESPONSE_COALESCING
 
 #define CMD_EMPTY 0xFF
-#define CMD_COMMAND_QUANTITY 5u
 #define CMD_COMMAND_LENGTH 3u
 
-#define CMD_LED 0
-#define CMD_LCD 1
-#define CMD_BIP 2
-#define CMD_OLD 3
-#define CMD_MOT 4
+/* Command descriptor flags */
+#define CMD_FLAG_NONE 0x00u
+/* Command is refused when it comes in a broadcast frame */
+#define CMD_FLAG_NO_BROADCAST 0x01u
+/* Command is refused inside a bat command */
+#define CMD_FLAG_NO_BATCH 0x02u
+/* Command is dispatched after the normal priority ones waiting with it */
+#define CMD_FLAG_LOW_PRIORITY 0x04u
+/* Command answered with a busy error stays queued and is retried,
+   handlers report busy errors before they change anything */
+#define CMD_FLAG_DEFER_BUSY 0x08u
+/* Command answers with data, its answer can be a full size body */
+#define CMD_FLAG_DATA_RESPONSE 0x10u
+
+/* Received commands wait for dispatch in a queue, normal priority ones
+   first, in order of arrival within a priority. Deferred command is
+   retried in every CMD_Run up to CMD_DEFER_MAX_RETRIES times, then its
+   busy error is answered. When the queue is full of deferred commands,
+   a new one is dispatched at once without deferral.
+   Command runs only when its longest answer fits the CMD transmit
+   queue, otherwise it is deferred the same way, or refused with
+   _CMDTXBS_ when it can not be deferred */
+#define CMD_QUEUE_SIZE 3u
+#define CMD_DEFER_MAX_RETRIES 100u
+#define CMD_PRIORITY_NORMAL 0u
+#define CMD_PRIORITY_LOW 1u
+#define CMD_PRIORITY_QUANTITY 2u
+
+/* Name lookup table, power of 2 and bigger than the number of commands.
+   Lookup stays O(1) while it is less than ~3/4 full */
+#define CMD_HASH_TABLE_SIZE 32u
+
+/* Argument schema of a command is up to CMD_ARG_MAX_QUANTITY argument
+   types, the dispatcher checks and decodes arguments before the handler
+   is called. Type is in the high nibble, number of characters in the low one */
+#define CMD_ARG_MAX_QUANTITY 4u
+#define CMD_ARG_NONE 0x00u
+#define CMD_ARG_TYPE_MASK 0xF0u
+#define CMD_ARG_SIZE_MASK 0x0Fu
+#define CMD_ARG_TYPE_HEX 0x10u
+#define CMD_ARG_TYPE_ENUM 0x20u
+#define CMD_ARG_TYPE_STRING 0x30u
+
+/* Hex numbers of 1, 2, 4 and 8 digits */
+#define CMD_ARG_HEX4 (CMD_ARG_TYPE_HEX | 1u)
+#define CMD_ARG_HEX8 (CMD_ARG_TYPE_HEX | 2u)
+#define CMD_ARG_HEX16 (CMD_ARG_TYPE_HEX | 4u)
+#define CMD_ARG_HEX32 (CMD_ARG_TYPE_HEX | 8u)
+/* One hex digit less than quantity (2..15) */
+#define CMD_ARG_ENUM(quantity) (CMD_ARG_TYPE_ENUM | (quantity))
+/* String of 1..15 characters, 0 takes the rest of the body
+   (at least one character), so it can only be the last argument */
+#define CMD_ARG_STRING(length) (CMD_ARG_TYPE_STRING | (length))
+#define CMD_ARG_STRING_REST CMD_ARG_STRING(0u)
+
+#define CMD_ARGS(...) { __VA_ARGS__ }
+
+typedef struct
+{
+	/* Hex and enum arguments */
+	uint32_t value;
+	/* String arguments, points into the received body */
+	const uint8_t *string;
+	uint8_t length;
+} ts_CMD_Arg;
+
+typedef struct
+{
+	ts_CMD_Arg arg[CMD_ARG_MAX_QUANTITY];
+} ts_CMD_Args;
+
+typedef void (*tf_CMD_Handler)(const ts_CMD_Args *args, uint8_t *error);
+
+/* Commands are registered in cmdlist.h */
+typedef enum {
+#define CMD_ENTRY(id, name, handler, check, poll, schema, flags) id,
+#include "cmdlist.h"
+#undef CMD_ENTRY
+	CMD_COMMAND_QUANTITY,
+} te_CMD_Commands;
+
+#define CMD_ENTRY(id, name, handler, check, poll, schema, flags) \
+	extern void handler(const ts_CMD_Args *args, uint8_t *error); \
+	extern void check(const ts_CMD_Args *args, uint8_t *error); \
+	extern uint8_t poll(uint8_t *error);
+#include "cmdlist.h"
+#undef CMD_ENTRY
 
 extern void CMD_Init(void);
 extern void CMD_Run(void);
-extern void CMD_ExecLedCommand(uint8_t *error);
-extern void CMD_ExecLCDCommand(uint8_t *error);
-extern void CMD_ExecBipCommand(uint8_t *error);
-extern void CMD_Execute(uint8_t *error);
+/* Decodes and executes one command body, used for received packages and scripts */
+extern void CMD_Execute(const uint8_t body[], const uint8_t length, uint8_t *error);
+extern void CMD_HandlePackage(const uint8_t recievedMessage[], const uint8_t length, uint8_t error);
+extern void CMD_Respond(const uint8_t recievedMessage[], const uint8_t length, const uint8_t error);
+extern void CMD_FlushResponses(void);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,39 @@
+/* Command registry, included several times by cmd module with different
+   CMD_ENTRY definitions, so it has no include guard.
+
+   CMD_ENTRY(id, name, handler, check, poll, schema, flags)
+     id        - command identifier in te_CMD_Commands
+     name      - 3 character name, as received in frame body
+     handler   - void handler(const ts_CMD_Args *args, uint8_t *error),
+                 can be defined in any module, prototype is generated
+     check     - the same signature as handler, reports errors the handler
+                 would report without changing anything, so bat can refuse
+                 a batch before any sub-command is executed.
+                 CMD_CheckNothing if there is nothing to check
+     poll      - tf_JOB_Poll telling when the work started by handler is
+                 finished, the command is then answered _ACC_<job id> and
+                 the job sends an event later. CMD_NoJob if the work is
+                 done when handler returns
+     schema    - CMD_ARGS() of CMD_ARG_* types following the name,
+                 decoded into args->arg[] in the same order
+     flags     - CMD_FLAG_* bits, priority and deferral policy of
+                 the command queue among them
+
+   A module adds a command with one line here and its handler.
+   Schemas may use constants of the module, cmd.c includes its header */
+CMD_ENTRY(CMD_LED, "led", CMD_ExecLedCommand,    CMD_CheckLedCommand,  CMD_NoJob,           CMD_ARGS(CMD_ARG_HEX4, CMD_ARG_HEX4), CMD_FLAG_NONE)
+CMD_ENTRY(CMD_LCD, "lcd", CMD_ExecLCDCommand,    CMD_CheckLCDCommand,  CMD_NoJob,           CMD_ARGS(CMD_ARG_HEX4, CMD_ARG_HEX4, CMD_ARG_STRING_REST), CMD_FLAG_NONE)
+CMD_ENTRY(CMD_BIP, "bip", CMD_ExecBipCommand,    CMD_CheckBipCommand,  CMD_PollBipCommand,  CMD_ARGS(CMD_ARG_HEX4), CMD_FLAG_DEFER_BUSY)
+CMD_ENTRY(CMD_OLD, "old", CMD_ExecOLEDCommand,   CMD_CheckOLEDCommand, CMD_PollOLEDCommand, CMD_ARGS(CMD_ARG_HEX4, CMD_ARG_HEX4, CMD_ARG_HEX8), CMD_FLAG_LOW_PRIORITY | CMD_FLAG_DEFER_BUSY)
+CMD_ENTRY(CMD_MOT, "mot", CMD_ExecMotCommand,    CMD_CheckMotCommand,  CMD_PollMotCommand,  CMD_ARGS(CMD_ARG_ENUM(2u), CMD_ARG_HEX16), CMD_FLAG_LOW_PRIORITY | CMD_FLAG_DEFER_BUSY)
+CMD_ENTRY(CMD_STS, "sts", CMD_ExecStsCommand,    CMD_CheckNothing,     CMD_NoJob,           CMD_ARGS(CMD_ARG_NONE), CMD_FLAG_NO_BROADCAST | CMD_FLAG_NO_BATCH | CMD_FLAG_DATA_RESPONSE)
+CMD_ENTRY(CMD_GET, "get", CMD_ExecGetCommand,    CMD_CheckNothing,     CMD_NoJob,           CMD_ARGS(CMD_ARG_STRING_REST), CMD_FLAG_NO_BROADCAST | CMD_FLAG_NO_BATCH | CMD_FLAG_DATA_RESPONSE)
+CMD_ENTRY(CMD_ADR, "adr", CMD_ExecAdrCommand,    CMD_CheckNothing,     CMD_NoJob,           CMD_ARGS(CMD_ARG_HEX8), CMD_FLAG_NO_BROADCAST | CMD_FLAG_NO_BATCH)
+CMD_ENTRY(CMD_MRD, "mrd", CMD_ExecMrdCommand,    CMD_CheckMrdCommand,  CMD_NoJob,           CMD_ARGS(CMD_ARG_ENUM(MEM_SPACE_QUANTITY), CMD_ARG_HEX16, CMD_ARG_HEX8), CMD_FLAG_NO_BROADCAST | CMD_FLAG_NO_BATCH | CMD_FLAG_DEFER_BUSY | CMD_FLAG_DATA_RESPONSE)
+CMD_ENTRY(CMD_MWR, "mwr", CMD_ExecMwrCommand,    CMD_CheckMwrCommand,  CMD_NoJob,           CMD_ARGS(CMD_ARG_ENUM(MEM_SPACE_QUANTITY), CMD_ARG_HEX16, CMD_ARG_STRING_REST), CMD_FLAG_NO_BROADCAST | CMD_FLAG_DEFER_BUSY)
+CMD_ENTRY(CMD_BAT, "bat", CMD_ExecBatCommand,    CMD_CheckNothing,     CMD_NoJob,           CMD_ARGS(CMD_ARG_STRING_REST), CMD_FLAG_NO_BATCH)
+CMD_ENTRY(CMD_SCW, "scw", SCR_ExecWriteCommand,  CMD_CheckNothing,     CMD_NoJob,           CMD_ARGS(CMD_ARG_ENUM(SCR_SLOT_QUANTITY), CMD_ARG_HEX8, CMD_ARG_STRING_REST), CMD_FLAG_NO_BATCH | CMD_FLAG_LOW_PRIORITY | CMD_FLAG_DEFER_BUSY)
+CMD_ENTRY(CMD_SCD, "scd", SCR_ExecDefineCommand, CMD_CheckNothing,     CMD_NoJob,           CMD_ARGS(CMD_ARG_ENUM(SCR_SLOT_QUANTITY), CMD_ARG_STRING(SCR_NAME_LENGTH), CMD_ARG_HEX8, CMD_ARG_HEX4), CMD_FLAG_NO_BATCH | CMD_FLAG_LOW_PRIORITY | CMD_FLAG_DEFER_BUSY)
+CMD_ENTRY(CMD_SCR, "scr", SCR_ExecRunCommand,    SCR_CheckRunCommand,  CMD_NoJob,           CMD_ARGS(CMD_ARG_STRING(SCR_NAME_LENGTH)), CMD_FLAG_NONE)
+CMD_ENTRY(CMD_SCS, "scs", SCR_ExecStopCommand,   CMD_CheckNothing,     CMD_NoJob,           CMD_ARGS(CMD_ARG_NONE), CMD_FLAG_NONE)
+CMD_ENTRY(CMD_TLM, "tlm", TLM_ExecTelemetryCommand, TLM_CheckTelemetryCommand, CMD_NoJob,           CMD_ARGS(CMD_ARG_ENUM(2u)), CMD_FLAG_NONE)
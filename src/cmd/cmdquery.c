@@ -0,0 +1,160 @@
+#include "cmdquery.h"
+
+#include "../defines.h"
+#include "../utils/utils.h"
+#include "../stringmanager/stringmanager.h"
+#include "../signalgateway/signalgateway.h"
+#include "../stepmotor/stepmotor.h"
+#include "../twsi/twsi.h"
+#include "../oled/oled.h"
+#include "../buzzer/buzzer.h"
+#include "../uart/uart.h"
+
+#define CMD_SIG_ID_LENGTH 1u
+#define CMD_SIG_FLAG_LENGTH 1u
+/* Object and error in one byte, then data */
+#define CMD_SIG_ETL_ERROR_LENGTH (STR_8BIT_STRING_LENGTH + STR_8BIT_STRING_LENGTH)
+
+extern ts_SM_Motor SM_motor;
+
+static uint8_t CMD_SignalLength(const uint8_t signal);
+static void CMD_WriteSignal(const uint8_t signal, uint8_t dst[]);
+
+uint8_t CMD_SignalLength(const uint8_t signal)
+{
+	uint8_t retVal = CMD_SIG_ID_LENGTH;
+
+	switch (signal)
+	{
+	case CMD_SIG_ADC_0:
+	case CMD_SIG_ADC_1:
+	case CMD_SIG_LED_DISPLAY:
+	case CMD_SIG_MOT_POSITION:
+	case CMD_SIG_MOT_STEPS:
+		retVal += STR_16BIT_STRING_LENGTH;
+		break;
+	case CMD_SIG_TICKER_SPEED:
+	case CMD_SIG_NODE_ADDRESS:
+	case CMD_SIG_ETL_COUNT:
+		retVal += STR_8BIT_STRING_LENGTH;
+		break;
+	case CMD_SIG_TWI_BUSY:
+	case CMD_SIG_OLED_SETTLED:
+	case CMD_SIG_BZ_ACTIVE:
+		retVal += CMD_SIG_FLAG_LENGTH;
+		break;
+	case CMD_SIG_ETL_ERRORS:
+		retVal += STR_8BIT_STRING_LENGTH + (GW_Get_ETL_errorBufferPointer() * CMD_SIG_ETL_ERROR_LENGTH);
+		break;
+	default:
+		retVal += LCD_CURRENT_CHARACTERS_QUANTITY;
+		break;
+	}
+
+	return retVal;
+}
+
+void CMD_WriteSignal(const uint8_t signal, uint8_t dst[])
+{
+	/* Signal ids and flags are valid hex digits, so error is a placeholder */
+	uint8_t error = ERR_NO_ERROR;
+	uint16_t value = 0u;
+	uint8_t speed = 0u;
+	uint8_t errorIdx = 0u;
+	uint8_t errorQuantity = 0u;
+	ts_ETL_ErrorLog *errorBuffer = 0;
+
+	dst[0] = STR_HexDigitToChar(signal, &error);
+	switch (signal)
+	{
+	case CMD_SIG_ADC_0:
+	case CMD_SIG_ADC_1:
+		GW_Read_ADC_ChannelValue(&value, signal - CMD_SIG_ADC_0);
+		STR_16BitHexToString(&dst[CMD_SIG_ID_LENGTH], value);
+		break;
+	case CMD_SIG_LED_DISPLAY:
+		GW_Read_LedDispayValue(&value);
+		STR_16BitHexToString(&dst[CMD_SIG_ID_LENGTH], value);
+		break;
+	case CMD_SIG_MOT_POSITION:
+		STR_16BitHexToString(&dst[CMD_SIG_ID_LENGTH], (uint16_t)SM_motor.position);
+		break;
+	case CMD_SIG_MOT_STEPS:
+		STR_16BitHexToString(&dst[CMD_SIG_ID_LENGTH], SM_motor.stepsToBeDone);
+		break;
+	case CMD_SIG_TICKER_SPEED:
+		GW_Read_TCK_CurrentSpeed(&speed);
+		STR_8BitHexToString(&dst[CMD_SIG_ID_LENGTH], speed);
+		break;
+	case CMD_SIG_NODE_ADDRESS:
+		STR_8BitHexToString(&dst[CMD_SIG_ID_LENGTH], UART_Get_NodeAddress());
+		break;
+	case CMD_SIG_ETL_COUNT:
+		STR_8BitHexToString(&dst[CMD_SIG_ID_LENGTH], GW_Get_ETL_errorBufferPointer());
+		break;
+	case CMD_SIG_TWI_BUSY:
+		dst[CMD_SIG_ID_LENGTH] = STR_HexDigitToChar(TWI_IsBusy(), &error);
+		break;
+	case CMD_SIG_OLED_SETTLED:
+		dst[CMD_SIG_ID_LENGTH] = STR_HexDigitToChar(OLED_IsSettled(&error), &error);
+		break;
+	case CMD_SIG_BZ_ACTIVE:
+		dst[CMD_SIG_ID_LENGTH] = STR_HexDigitToChar(BZ_IsActive(), &error);
+		break;
+	case CMD_SIG_ETL_ERRORS:
+		errorQuantity = GW_Get_ETL_errorBufferPointer();
+		errorBuffer = GW_Get_ETL_errorBuffer();
+		STR_8BitHexToString(&dst[CMD_SIG_ID_LENGTH], errorQuantity);
+		dst = &dst[CMD_SIG_ID_LENGTH + STR_8BIT_STRING_LENGTH];
+		for(errorIdx = 0u; errorIdx < errorQuantity; errorIdx++)
+		{
+			STR_8BitHexToString(dst, (errorBuffer[errorIdx].object << HALF_OF_BYTE_LENTH) | errorBuffer[errorIdx].error);
+			STR_8BitHexToString(&dst[STR_8BIT_STRING_LENGTH], errorBuffer[errorIdx].data);
+			dst = &dst[CMD_SIG_ETL_ERROR_LENGTH];
+		}
+		break;
+	default:
+		U_ArrCpy(&dst[CMD_SIG_ID_LENGTH], GW_Get_LCD_String(), LCD_CURRENT_CHARACTERS_QUANTITY);
+		break;
+	}
+}
+
+uint8_t CMD_QuerySignals(const uint8_t ids[], const uint8_t idQuantity, uint8_t dst[], const uint8_t dstSize, uint8_t *error)
+{
+	uint8_t retVal = 0u;
+	uint8_t idIdx = 0u;
+	uint8_t signal = 0u;
+	uint8_t lastSignal = 0u;
+	uint8_t signalLength = 0u;
+
+	for(idIdx = 0u; (idIdx < idQuantity) && ((*error) == ERR_NO_ERROR); idIdx++)
+	{
+		if(ids[idIdx] == CMD_SIG_SNAPSHOT)
+		{
+			signal = 0u;
+			lastSignal = CMD_SIG_SNAPSHOT_LAST;
+		} else
+		{
+			signal = STR_CharToHexDigit(ids[idIdx], error);
+			lastSignal = signal;
+			if( ((*error) == ERR_NO_ERROR) && (signal >= CMD_SIG_QUANTITY) )
+			{
+				(*error) = ERR_CMD_ARG_OUT_OF_RANGE;
+			}
+		}
+		for( ; (signal <= lastSignal) && ((*error) == ERR_NO_ERROR); signal++)
+		{
+			signalLength = CMD_SignalLength(signal);
+			if( (retVal + signalLength) > dstSize )
+			{
+				(*error) = ERR_CMD_RESPONSE_TOO_LONG;
+			} else
+			{
+				CMD_WriteSignal(signal, &dst[retVal]);
+				retVal += signalLength;
+			}
+		}
+	}
+
+	return retVal;
+}
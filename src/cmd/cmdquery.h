@@ -0,0 +1,39 @@
+#ifndef cmdquery_h
+#define cmdquery_h
+
+#include <avr/io.h>
+
+/* Signals read back by the get command. Request is get followed by one
+   hex digit per signal, or '*' for the snapshot of all scalar signals.
+   Response is GET followed by signal id and its value for every signal:
+     ADC, LED display, motor position and steps - 4 hex digits
+     ticker speed, node address, ETL error count - 2 hex digits
+     TWI busy, OLED settled, buzzer active       - 1 hex digit
+     ETL errors - 2 hex count, then per error 2 hex object and error
+                  (as on LCD) and 2 hex data
+     LCD        - LCD_CURRENT_CHARACTERS_QUANTITY characters as they are */
+typedef enum {
+	CMD_SIG_ADC_0,
+	CMD_SIG_ADC_1,
+	CMD_SIG_LED_DISPLAY,
+	CMD_SIG_TICKER_SPEED,
+	CMD_SIG_MOT_POSITION,
+	CMD_SIG_MOT_STEPS,
+	CMD_SIG_TWI_BUSY,
+	CMD_SIG_OLED_SETTLED,
+	CMD_SIG_BZ_ACTIVE,
+	CMD_SIG_NODE_ADDRESS,
+	CMD_SIG_ETL_COUNT,
+	CMD_SIG_ETL_ERRORS,
+	CMD_SIG_LCD,
+	CMD_SIG_QUANTITY,
+} te_CMD_Signals;
+
+#define CMD_SIG_SNAPSHOT '*'
+/* Snapshot holds signals from the first one up to this one */
+#define CMD_SIG_SNAPSHOT_LAST CMD_SIG_ETL_COUNT
+
+/* Writes id and value of every requested signal to dst, returns length */
+extern uint8_t CMD_QuerySignals(const uint8_t ids[], const uint8_t idQuantity, uint8_t dst[], const uint8_t dstSize, uint8_t *error);
+
+#endif
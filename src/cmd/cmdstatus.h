@@ -0,0 +1,43 @@
+/* Status responses, included by cmd module with CMD_STATUS defined,
+   so it has no include guard.
+
+   CMD_STATUS(error, length, body)
+     error     - ERR_* code answered by this frame
+     length    - body length as 2 hex digits, checked at compile time
+     body      - response body string
+
+   Every line becomes a complete frame in flash, responses are queued
+   by its address. Codes without a line are answered _NTEX_ */
+CMD_STATUS(ERR_NO_ERROR,                    04, "_OK_")
+CMD_STATUS(ERR_STR_WRONG_CHARACTER,         09, "_STRWRCR_")
+CMD_STATUS(ERR_STR_WRONG_HEX_DIGIT,         09, "_STRSWHX_")
+CMD_STATUS(ERR_CMD_COMMAND_NOT_FOUND,       09, "_CMDCMNF_")
+CMD_STATUS(ERR_CMD_CURROPTED_PACKAGE,       09, "_CMDCRPG_")
+CMD_STATUS(ERR_CMD_LED_WRONG_LED_ID,        09, "_LEDWLID_")
+CMD_STATUS(ERR_CMD_LED_WRONG_LED_STATE,     09, "_LEDWLST_")
+CMD_STATUS(ERR_CMD_LCD_WRONG_LINE_ID,       09, "_LCDWLID_")
+CMD_STATUS(ERR_CMD_LCD_WRONG_POSITION,      09, "_LCDWPOS_")
+CMD_STATUS(ERR_CMD_BZ_WRONG_TIME,           09, "_BUZWRTM_")
+CMD_STATUS(ERR_CMD_OLED_WRONG_CONTROL_BYTE, 09, "_OLDWRCB_")
+CMD_STATUS(ERR_CMD_OLED_WRONG_COMMAND_ID,   09, "_OLDWCID_")
+CMD_STATUS(ERR_CMD_OLED_FAIL_TO_STOP,       09, "_OLDFSOP_")
+CMD_STATUS(ERR_CMD_OLED_FAIL_TO_START,      09, "_OLDFSRT_")
+CMD_STATUS(ERR_CMD_MOT_WRONG_DIRECTION_ID,  09, "_MOTWDID_")
+CMD_STATUS(ERR_CMD_MOT_IS_BUSY,             09, "_MOTBUSY_")
+CMD_STATUS(ERR_CMD_TWI_IS_BUSY,             09, "_TWIBUSY_")
+CMD_STATUS(ERR_UART_WRONG_NODE_ADDRESS,     09, "_UARWNAD_")
+CMD_STATUS(ERR_CMD_NO_BROADCAST,            09, "_CMDNBRC_")
+CMD_STATUS(ERR_CMD_WRONG_ARG_LENGTH,        09, "_CMDWALN_")
+CMD_STATUS(ERR_CMD_ARG_OUT_OF_RANGE,        09, "_CMDAROR_")
+CMD_STATUS(ERR_CMD_NO_BATCH,                09, "_CMDNBAT_")
+CMD_STATUS(ERR_SCR_BUSY,                    09, "_SCRBUSY_")
+CMD_STATUS(ERR_SCR_WRONG_SCRIPT,            09, "_SCRWSCR_")
+CMD_STATUS(ERR_SCR_NOT_FOUND,               09, "_SCRNFND_")
+CMD_STATUS(ERR_JOB_FULL,                    09, "_JOBFULL_")
+CMD_STATUS(ERR_CMD_RESPONSE_TOO_LONG,       09, "_CMDRSTL_")
+CMD_STATUS(ERR_MEM_WRONG_ADDRESS,           09, "_MEMWADR_")
+CMD_STATUS(ERR_MEM_BUSY,                    09, "_MEMBUSY_")
+CMD_STATUS(ERR_CMD_TX_BUSY,                 09, "_CMDTXBS_")
+CMD_STATUS(ERR_TLM_NOT_ON_BUS,              09, "_TLMNBUS_")
+CMD_STATUS(ERR_CMD_BZ_IS_BUSY,              09, "_BUZBUSY_")
+CMD_STATUS(ERR_CMD_LCD_FIELD_TAKEN,         09, "_LCDFTKN_")
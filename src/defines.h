@@ -48,6 +48,13 @@
 #define ETL_TWI_TW_MR_DATA_NACK_TIMEOUT 0x0Bu
 #define ETL_TWI_UNDEFIND 0x0Cu
 
+#define ETL_UART_OBJ 0x06
+#define ETL_UART_OVERRUN 0x00
+#define ETL_UART_FRAMING_ERROR 0x01
+#define ETL_UART_PARITY_ERROR 0x02
+#define ETL_UART_RING_OVERFLOW 0x03
+#define ETL_UART_BAD_FRAME 0x04
+
 #define ERR_NO_ERROR 0u
 #define ERR_STR_WRONG_CHARACTER 1u
 #define ERR_STR_WRONG_HEX_DIGIT 2u
@@ -65,6 +72,23 @@
 #define ERR_CMD_MOT_WRONG_DIRECTION_ID 14u
 #define ERR_CMD_MOT_IS_BUSY 15u
 #define ERR_CMD_TWI_IS_BUSY 16u
+#define ERR_UART_WRONG_NODE_ADDRESS 17u
+#define ERR_CMD_NO_BROADCAST 18u
+#define ERR_CMD_WRONG_ARG_LENGTH 19u
+#define ERR_CMD_ARG_OUT_OF_RANGE 20u
+#define ERR_CMD_NO_BATCH 21u
+#define ERR_SCR_BUSY 22u
+#define ERR_SCR_WRONG_SCRIPT 23u
+#define ERR_SCR_NOT_FOUND 24u
+#define ERR_JOB_FULL 25u
+#define ERR_JOB_TIMEOUT 26u
+#define ERR_CMD_RESPONSE_TOO_LONG 27u
+#define ERR_MEM_WRONG_ADDRESS 28u
+#define ERR_MEM_BUSY 29u
+#define ERR_CMD_TX_BUSY 30u
+#define ERR_TLM_NOT_ON_BUS 31u
+#define ERR_CMD_BZ_IS_BUSY 32u
+#define ERR_CMD_LCD_FIELD_TAKEN 33u
 
 
 
@@ -193,6 +193,11 @@ typedef enum {
 	BUZZER,
 	/* Led for run indication */
 	LED_RUN,
+	/* Software UART */
+	SUART_TX,
+	SUART_RX,
+	/* RS-485 transceiver driver enable */
+	RS485_DE,
 	/* te_DIO_Pins element's quantity */
 	PIN_QUANTITY,
 } te_DIO_Pins;
@@ -3,33 +3,30 @@
 void ETL_Run(void)
 {
     ts_ETL_ErrorLog *errorBuffer = 0u;
-    uint8_t hexString[STR_8BIT_STRING_LENGTH];
+    uint8_t errorBytes[ETL_LCD_ERROR_QUANTITY * ETL_LCD_ERROR_BYTES];
+    uint8_t errorString[ETL_LCD_ERROR_QUANTITY * ETL_LCD_ERROR_BYTES * STR_8BIT_STRING_LENGTH];
     uint8_t errorIdx = 0u;
-    uint8_t tmpErrorIdx = 0u;
     uint8_t errorQuantity = 0u;
-    uint8_t LCDidx = 0u;
-    
+    uint8_t shownQuantity = 0u;
 
     errorQuantity = GW_Get_ETL_errorBufferPointer();
     errorBuffer = GW_Get_ETL_errorBuffer();
-    for(errorIdx = 0; (errorIdx < errorQuantity) && (LCDidx < LCD_LINE_LENGTH); errorIdx++)
+    if(errorQuantity > 0u)
     {
-        STR_8BitHexToString(hexString, (errorBuffer[errorIdx].object << HALF_OF_BYTE_LENTH) | errorBuffer[errorIdx].error);
-        STR_WriteStringToLCD(LCD_LINE_1, LCDidx, STR_8BIT_STRING_LENGTH, (const char*)hexString);
-        LCDidx += STR_8BIT_STRING_LENGTH;
-        STR_8BitHexToString(hexString, errorBuffer[errorIdx].data);
-        STR_WriteStringToLCD(LCD_LINE_1, LCDidx, STR_8BIT_STRING_LENGTH, (const char*)hexString);
-        LCDidx += STR_8BIT_STRING_LENGTH;
-        tmpErrorIdx++;
+        /* The first errors fill their own field, the count tells whether
+           there are more */
+        shownQuantity = errorQuantity;
+        if(shownQuantity > ETL_LCD_ERROR_QUANTITY)
+        {
+            shownQuantity = ETL_LCD_ERROR_QUANTITY;
+        }
+        for(errorIdx = 0; errorIdx < shownQuantity; errorIdx++)
+        {
+            errorBytes[errorIdx * ETL_LCD_ERROR_BYTES] = (errorBuffer[errorIdx].object << HALF_OF_BYTE_LENTH) | errorBuffer[errorIdx].error;
+            errorBytes[(errorIdx * ETL_LCD_ERROR_BYTES) + 1u] = errorBuffer[errorIdx].data;
+        }
+        STR_HexEncode(errorString, errorBytes, shownQuantity * ETL_LCD_ERROR_BYTES);
+        LAY_SetText(LAY_ETL_ERRORS, (const char*)errorString, shownQuantity * ETL_LCD_ERROR_BYTES * STR_8BIT_STRING_LENGTH);
+        LAY_SetNumber(LAY_ETL_COUNT, errorQuantity);
     }
-    LCDidx = 0u;
-    for(errorIdx = tmpErrorIdx; errorIdx < errorQuantity; errorIdx++)
-    {
-        STR_8BitHexToString(hexString, (errorBuffer[errorIdx].object << HALF_OF_BYTE_LENTH) | errorBuffer[errorIdx].error);
-        STR_WriteStringToLCD(LCD_LINE_2, LCDidx, STR_8BIT_STRING_LENGTH, (const char*)hexString);
-        LCDidx += STR_8BIT_STRING_LENGTH;
-        STR_8BitHexToString(hexString, errorBuffer[errorIdx].data);
-        STR_WriteStringToLCD(LCD_LINE_2, LCDidx, STR_8BIT_STRING_LENGTH, (const char*)hexString);
-        LCDidx += STR_8BIT_STRING_LENGTH;
-    }
-}
\ No newline at end of file
+}
@@ -3,8 +3,14 @@
 
 #include "../stringmanager/stringmanager.h"
 #include "../signalgateway/signalgateway.h"
+#include "../layout/layout.h"
 #include "../defines.h"
 
+/* Errors shown in LAY_ETL_ERRORS, each as object and error digits
+   followed by data byte */
+#define ETL_LCD_ERROR_QUANTITY 1u
+#define ETL_LCD_ERROR_BYTES 2u
+
 void ETL_Run(void);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,112 @@
+#include "job.h"
+
+#include <avr/pgmspace.h>
+#include "../defines.h"
+#include "../uart/uart.h"
+#include "../stringmanager/stringmanager.h"
+
+#define JOB_STATE_FREE 0u
+#define JOB_STATE_RUNNING 1u
+/* Work is finished, but the event is not queued yet */
+#define JOB_STATE_DONE 2u
+
+#define JOB_EVENT_TAG_LENGTH 5u
+#define JOB_EVENT_LENGTH (JOB_EVENT_TAG_LENGTH + JOB_ID_LENGTH + STR_8BIT_STRING_LENGTH)
+#define JOB_EVENT_FORMAT "_EVT_%02X%02X"
+
+typedef struct
+{
+	uint8_t state;
+	uint8_t id;
+	uint8_t status;
+	uint16_t ticks;
+	tf_JOB_Poll poll;
+} ts_JOB_Job;
+
+static ts_JOB_Job JOB_jobs[JOB_QUANTITY];
+static uint8_t JOB_nextId = 0u;
+
+void JOB_Init(void)
+{
+	uint8_t jobIdx = 0u;
+
+	for(jobIdx = 0u; jobIdx < JOB_QUANTITY; jobIdx++)
+	{
+		JOB_jobs[jobIdx].state = JOB_STATE_FREE;
+	}
+	JOB_nextId = 0u;
+}
+
+uint8_t JOB_IsSlotFree(void)
+{
+	uint8_t jobIdx = 0u;
+	uint8_t retVal = D_FALSE;
+
+	for(jobIdx = 0u; (jobIdx < JOB_QUANTITY) && (retVal == D_FALSE); jobIdx++)
+	{
+		if(JOB_jobs[jobIdx].state == JOB_STATE_FREE)
+		{
+			retVal = D_TRUE;
+		}
+	}
+
+	return retVal;
+}
+
+uint8_t JOB_Start(const tf_JOB_Poll poll)
+{
+	uint8_t jobIdx = 0u;
+	uint8_t retVal = JOB_nextId;
+
+	/* Caller checks JOB_IsSlotFree before the command is executed */
+	while( (jobIdx < (JOB_QUANTITY - 1u)) && (JOB_jobs[jobIdx].state != JOB_STATE_FREE) )
+	{
+		jobIdx++;
+	}
+	JOB_jobs[jobIdx].state = JOB_STATE_RUNNING;
+	JOB_jobs[jobIdx].id = JOB_nextId;
+	JOB_jobs[jobIdx].status = ERR_NO_ERROR;
+	JOB_jobs[jobIdx].ticks = 0u;
+	JOB_jobs[jobIdx].poll = poll;
+	JOB_nextId++;
+
+	return retVal;
+}
+
+void JOB_Run(void)
+{
+	uint8_t jobIdx = 0u;
+	/* One more byte for the terminating zero of STR_Format */
+	char body[JOB_EVENT_LENGTH + 1u];
+	ts_JOB_Job *job = 0;
+
+	for(jobIdx = 0u; jobIdx < JOB_QUANTITY; jobIdx++)
+	{
+		job = &JOB_jobs[jobIdx];
+		if(job->state == JOB_STATE_RUNNING)
+		{
+			job->ticks++;
+			if( (job->poll(&job->status) == D_TRUE) || (job->status != ERR_NO_ERROR) )
+			{
+				job->state = JOB_STATE_DONE;
+			} else
+			if(job->ticks >= JOB_TIMEOUT_TICKS)
+			{
+				job->status = ERR_JOB_TIMEOUT;
+				job->state = JOB_STATE_DONE;
+			} else
+			{
+				/* Still working */
+			}
+		}
+		if(job->state == JOB_STATE_DONE)
+		{
+			STR_Format(body, sizeof(body), PSTR(JOB_EVENT_FORMAT), job->id, job->status);
+			/* Event is not lost when command channel is full, it is sent later */
+			if(UART_TX_WriteUnsolicitedPackage(UART_CH_CMD, (uint8_t *)body, JOB_EVENT_LENGTH) == D_TRUE)
+			{
+				job->state = JOB_STATE_FREE;
+			}
+		}
+	}
+}
@@ -0,0 +1,27 @@
+#ifndef job_h
+#define job_h
+
+#include <avr/io.h>
+
+/* Commands that keep working after they return (motor move, bip, OLED
+   state changes) are answered _ACC_<id> at once, and when the work is
+   finished the job sends an event frame on the command channel:
+     _EVT_<id 2 hex><status 2 hex>
+   Status is ERR_NO_ERROR or the failure reason, ERR_JOB_TIMEOUT if the
+   work is not done in JOB_TIMEOUT_TICKS. Events are not sent in
+   UART_RS485_MODE, the job is just freed when it finishes */
+
+#define JOB_QUANTITY 4u
+/* JOB_Run is called every 10 ms */
+#define JOB_TIMEOUT_TICKS 6000u
+#define JOB_ID_LENGTH 2u
+
+/* Returns D_TRUE when the work is finished, sets error if it failed */
+typedef uint8_t (*tf_JOB_Poll)(uint8_t *error);
+
+extern void JOB_Init(void);
+extern void JOB_Run(void);
+extern uint8_t JOB_IsSlotFree(void);
+extern uint8_t JOB_Start(const tf_JOB_Poll poll);
+
+#endif
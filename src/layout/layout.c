@@ -0,0 +1,152 @@
+#include "layout.h"
+
+#include <avr/pgmspace.h>
+
+#include "../signalgateway/signalgateway.h"
+
+typedef void (*tf_LAY_Writer)(char dst[], const uint8_t width, const char text[], const uint8_t length, const uint8_t signLength);
+
+typedef struct
+{
+	uint8_t offset;
+	uint8_t width;
+	tf_LAY_Writer writer;
+	uint8_t decimals;
+	char unit[STR_UNIT_MAX_LENGTH + 1u];
+} ts_LAY_Field;
+
+/* Every format is its own writer, so alignment and filling are chosen
+   when the layout is compiled and not at every update. They are not
+   static, a layout does not have to use every format */
+void LAY_WriteRight(char dst[], const uint8_t width, const char text[], const uint8_t length, const uint8_t signLength);
+void LAY_WriteLeft(char dst[], const uint8_t width, const char text[], const uint8_t length, const uint8_t signLength);
+void LAY_WriteZeros(char dst[], const uint8_t width, const char text[], const uint8_t length, const uint8_t signLength);
+
+#define LAY_FORMAT_RIGHT LAY_WriteRight
+#define LAY_FORMAT_LEFT LAY_WriteLeft
+#define LAY_FORMAT_ZEROS LAY_WriteZeros
+#define LAY_FORMAT_TEXT 0
+
+/* Characters of a field as bits of the LCD string */
+#define LAY_FIELD_MASK(line, position, width) ( ((1ull << (width)) - 1ull) << (((line) * LCD_LINE_LENGTH) + (position)) )
+
+/* Does not compile if a field leaves its line or its unit is too long */
+#define LAY_FIELD(id, line, position, width, format, decimals, unit) \
+	typedef uint8_t LayFieldCheck_##id[( ((position) + (width)) <= LCD_LINE_LENGTH ) && ( (width) > 0u ) && \
+		( (sizeof(unit) - 1u) <= STR_UNIT_MAX_LENGTH ) ? 1 : -1];
+#include "layoutlist.h"
+#undef LAY_FIELD
+
+/* Does not compile if fields overlap: sum of the masks equals their
+   bitwise or only if no character belongs to two fields */
+typedef uint8_t LayFieldOverlapCheck[( (0ull
+#define LAY_FIELD(id, line, position, width, format, decimals, unit) + LAY_FIELD_MASK(line, position, width)
+#include "layoutlist.h"
+#undef LAY_FIELD
+	) == (0ull
+#define LAY_FIELD(id, line, position, width, format, decimals, unit) | LAY_FIELD_MASK(line, position, width)
+#include "layoutlist.h"
+#undef LAY_FIELD
+	) ) ? 1 : -1];
+
+/* Characters owned by fields, one bit per character of the LCD string */
+typedef uint8_t LayFieldCharactersSizeCheck[((LCD_CURRENT_CHARACTERS_QUANTITY) <= 32u) ? 1 : -1];
+static const uint32_t LayFieldCharacters = (uint32_t)(0ull
+#define LAY_FIELD(id, line, position, width, format, decimals, unit) | LAY_FIELD_MASK(line, position, width)
+#include "layoutlist.h"
+#undef LAY_FIELD
+	);
+
+static const ts_LAY_Field PROGMEM LayFields[LAY_FIELD_QUANTITY] = {
+#define LAY_FIELD(id, line, position, width, format, decimals, unit) \
+	{ ((line) * LCD_LINE_LENGTH) + (position), width, format, decimals, unit },
+#include "layoutlist.h"
+#undef LAY_FIELD
+};
+
+void LAY_WriteRight(char dst[], const uint8_t width, const char text[], const uint8_t length, const uint8_t signLength)
+{
+	(void)signLength;
+	STR_FillArray(dst, 0u, width - length, ' ');
+	STR_WriteStringToArray(text, dst, width - length, length);
+}
+
+void LAY_WriteLeft(char dst[], const uint8_t width, const char text[], const uint8_t length, const uint8_t signLength)
+{
+	(void)signLength;
+	STR_WriteStringToArray(text, dst, 0u, length);
+	STR_FillArray(dst, length, width - length, ' ');
+}
+
+void LAY_WriteZeros(char dst[], const uint8_t width, const char text[], const uint8_t length, const uint8_t signLength)
+{
+	/* Zeros go between the sign and the digits */
+	STR_WriteStringToArray(text, dst, 0u, signLength);
+	STR_FillArray(dst, signLength, width - length, '0');
+	STR_WriteStringToArray(&text[signLength], dst, signLength + (width - length), length - signLength);
+}
+
+/* Fields are formatted in a local copy, the gateway writes only the
+   changed characters, so LCD_Run does not resend a field with the same
+   value. Fields fit a line, see LayFieldCheck */
+void LAY_SetNumber(const uint8_t fieldId, const int32_t value)
+{
+	ts_LAY_Field field;
+	char tmpString[STR_FIXED_STRING_LENGTH];
+	char tmpField[LCD_LINE_LENGTH];
+	uint8_t length = 0u;
+
+	if(fieldId < LAY_FIELD_QUANTITY)
+	{
+		memcpy_P(&field, &LayFields[fieldId], sizeof(ts_LAY_Field));
+		if(field.writer != 0)
+		{
+			length = STR_FixedToString(tmpString, value, field.decimals, field.unit);
+			if(length > field.width)
+			{
+				/* Cut off value would be misleading, the field shows overflow */
+				STR_FillArray(tmpField, 0u, field.width, STR_OVERFLOW_CHARACTER);
+			} else
+			{
+				field.writer(tmpField, field.width, tmpString, length, (value < 0));
+			}
+			GW_Write_LCD_String(field.offset, (const uint8_t*)tmpField, field.width);
+		}
+	}
+}
+
+void LAY_SetText(const uint8_t fieldId, const char text[], const uint8_t length)
+{
+	char tmpField[LCD_LINE_LENGTH];
+	uint8_t width = 0u;
+	uint8_t textLength = length;
+
+	if(fieldId < LAY_FIELD_QUANTITY)
+	{
+		width = pgm_read_byte(&LayFields[fieldId].width);
+		if(textLength > width)
+		{
+			textLength = width;
+		}
+		STR_WriteStringToArray(text, tmpField, 0u, textLength);
+		STR_FillArray(tmpField, textLength, width - textLength, ' ');
+		GW_Write_LCD_String(pgm_read_byte(&LayFields[fieldId].offset), (const uint8_t*)tmpField, width);
+	}
+}
+
+uint8_t LAY_IsAreaFree(const uint8_t lineId, const uint8_t position, const uint8_t length)
+{
+	uint8_t offset = (lineId * LCD_LINE_LENGTH) + position;
+	uint8_t idx = 0u;
+	uint8_t retVal = D_TRUE;
+
+	for(idx = 0u; (idx < length) && (retVal == D_TRUE); idx++)
+	{
+		if( ((LayFieldCharacters >> (offset + idx)) & 1ul) != 0ul )
+		{
+			retVal = D_FALSE;
+		}
+	}
+
+	return retVal;
+}
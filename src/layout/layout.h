@@ -0,0 +1,28 @@
+#ifndef layout_h
+#define layout_h
+
+#include <avr/io.h>
+
+#include "../stringmanager/stringmanager.h"
+#include "../defines.h"
+
+/* Display fields declared in layoutlist.h, modules update them by id
+   instead of computing line, position and format at every call */
+typedef enum
+{
+#define LAY_FIELD(id, line, position, width, format, decimals, unit) id,
+#include "layoutlist.h"
+#undef LAY_FIELD
+	LAY_FIELD_QUANTITY
+} te_LAY_Fields;
+
+/* Writes value with the format of the field, fields of LAY_FORMAT_TEXT
+   are not changed */
+extern void LAY_SetNumber(const uint8_t fieldId, const int32_t value);
+/* Writes length characters of text into the field, cut to its width,
+   the rest of the field is filled with spaces */
+extern void LAY_SetText(const uint8_t fieldId, const char text[], const uint8_t length);
+/* D_TRUE if no field owns any of length characters from position of the line */
+extern uint8_t LAY_IsAreaFree(const uint8_t lineId, const uint8_t position, const uint8_t length);
+
+#endif
@@ -0,0 +1,21 @@
+/* Display fields, included by layout module with different LAY_FIELD
+   definitions, so it has no include guard.
+
+   LAY_FIELD(id, line, position, width, format, decimals, unit)
+     id        - field identifier in te_LAY_Fields
+     line      - LCD_LINE_1 or LCD_LINE_2
+     position  - first character of the field in the line
+     width     - characters owned by the field
+     format    - LAY_FORMAT_* of values set by LAY_SetNumber,
+                 LAY_FORMAT_TEXT for fields set by LAY_SetText
+     decimals  - digits after the decimal point, value is scaled by
+                 10^decimals
+     unit      - suffix of up to STR_UNIT_MAX_LENGTH characters
+
+   Fields must fit their line and must not overlap each other, the layout
+   module does not compile otherwise. Characters of no field stay free for
+   the lcd command, which refuses to write over a field, so only what a
+   scheduled writer draws is declared here: ETL_Run shows the first error
+   and the count of logged errors every second */
+LAY_FIELD(LAY_ETL_COUNT,  LCD_LINE_1,  5u,  2u, LAY_FORMAT_LEFT,   0u, "E")
+LAY_FIELD(LAY_ETL_ERRORS, LCD_LINE_1, 10u,  4u, LAY_FORMAT_TEXT,   0u, "")
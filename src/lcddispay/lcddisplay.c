@@ -84,6 +84,12 @@
 #endif
 
 
+/* Display address counter is not known after init and after the last
+   character of a line, the next character needs a cursor move */
+#define LCD_CURSOR_UNKNOWN 0xFFu
+
+#define LCD_FILL_CHARACTER '*'
+
 #define LCD_CLEAR_E_SIGNAL_POINT 200u
 #define LCD_DELAY_POINT 201u
 
@@ -116,9 +122,7 @@ int16_t LCD_delayCounter = 0u;
 
 uint8_t LCD_currentCharIndex = 0u;
 
-uint8_t LCD_cursorPosition = 0u;
-
-uint8_t LCD_currentLine = LCD_LINE_1;
+uint8_t LCD_cursorPosition = LCD_CURSOR_UNKNOWN;
 
 uint8_t LCD_tmpDataBuffer = 0u;
 
@@ -152,10 +156,10 @@ void LCD_Init(void)
 void LCD_FillCurrentCharacters(void) 
 {
     uint8_t idx = 0u;
-    uint8_t *tmpString = 0u;
-    tmpString = GW_Get_LCD_String();
+    const uint8_t fillCharacter = (uint8_t)LCD_FILL_CHARACTER;
+    /* Characters already showing the fill character stay clean */
     for(idx=0; idx<LCD_CURRENT_CHARACTERS_QUANTITY; idx++) {
-        tmpString[idx] = (uint8_t)'*';
+        GW_Write_LCD_String(idx, &fillCharacter, 1u);
     }
 }
 
@@ -210,6 +214,7 @@ void LCD_SendChar(uint8_t charact)
 void LCD_Run(void) 
 {
     uint8_t *tmpString = 0;
+    uint8_t dirtyIdx = GW_LCD_NO_DIRTY_CHARACTER;
 
     tmpString = GW_Get_LCD_String();
 
@@ -315,34 +320,37 @@ void LCD_Run(void)
         LCD_delayCounter = 1u;
         break;
     case LCD_CHARACTER_WRITING_HIGH_POINT:
-        LCD_SET_REGISTER_SELECT_SIGNAL;
-        
-        /* If writing to line 1 is compleate */
-        if( (LCD_currentCharIndex >= LCD_LINE_LENGTH) && (LCD_currentLine == LCD_LINE_1) ) 
+        /* Only characters changed by the writers are sent, round robin
+           from the last one, so a field updated all the time does not
+           hold back the others */
+        dirtyIdx = GW_Find_LCD_Dirty(LCD_currentCharIndex);
+        if(dirtyIdx == GW_LCD_NO_DIRTY_CHARACTER)
         {
-            
-            /* Then we move corsor to position LCD_LINE_LENGTH (16, first position of line 2) */
-            LCD_cursorPosition = LCD_LINE_LENGTH;
-            LCD_currentPoint = LCD_SET_CURSOR_POSITION_HIGH_POINT;
-        } else 
-        /* Or, if writing to line 1 and 2 is compleate */
-        if(LCD_currentCharIndex >= LCD_CURRENT_CHARACTERS_QUANTITY) 
+            /* Nothing changed, the state is checked again next tick */
+        } else
+        /* Cursor is moved only to skip clean characters or to change line */
+        if(dirtyIdx != LCD_cursorPosition)
         {
-            /* Then we move cursor to position 0 (first position of line 1) */
-            LCD_nextPoint = LCD_CHARACTER_WRITING_HIGH_POINT;
+            LCD_cursorPosition = dirtyIdx;
             LCD_currentPoint = LCD_SET_CURSOR_POSITION_HIGH_POINT;
-            LCD_currentCharIndex = 0;
-            LCD_cursorPosition = 0;
-        } else 
-        /* Any other case means, that we still fill lines */
+        } else
         {
-            LCD_tmpDataBuffer = tmpString[LCD_currentCharIndex];
-            /*todo*/
+            /* Writer may change the character again while it is sent,
+               then it becomes dirty once more */
+            GW_Clear_LCD_Dirty(dirtyIdx);
+            LCD_tmpDataBuffer = tmpString[dirtyIdx];
             LCD_WriteData(LCD_tmpDataBuffer >> HALF_OF_BYTE_LENTH);
             LCD_SET_REGISTER_SELECT_SIGNAL;
             LCD_SET_ENABLE_SIGNAL;
-           
-            LCD_currentCharIndex++;
+
+            /* Address counter of the display does not go on from the end
+               of line 1 to line 2 */
+            LCD_cursorPosition++;
+            if( (LCD_cursorPosition % LCD_LINE_LENGTH) == 0u )
+            {
+                LCD_cursorPosition = LCD_CURSOR_UNKNOWN;
+            }
+            LCD_currentCharIndex = dirtyIdx + 1u;
             LCD_nextPoint = LCD_CHARACTER_WRITING_LOW_POINT;
             LCD_currentPoint = LCD_CLEAR_E_SIGNAL_POINT;
         }
@@ -367,7 +375,10 @@ void LCD_Run(void)
         LCD_CLEAR_REGISTER_SELECT_SIGNAL;
         LCD_WriteData(LCD_CLEAR_DISPAY_CMD >> HALF_OF_BYTE_LENTH); // <----
         LCD_SET_ENABLE_SIGNAL;
+        /* Cleared display shows nothing of the buffer */
+        GW_Mark_LCD_Dirty();
         LCD_currentCharIndex = 0;
+        LCD_cursorPosition = LCD_CURSOR_UNKNOWN;
         
         LCD_currentPoint = LCD_CLEAR_E_SIGNAL_POINT;
         LCD_tmpNextPoint = LCD_nextPoint;
@@ -393,13 +404,11 @@ void LCD_Run(void)
         if( LCD_cursorPosition < LCD_LINE_LENGTH ) 
         {
             LCD_tmpDataBuffer = LCD_BEGINNING_OF_LINE_1_ADRESS + LCD_cursorPosition;
-            LCD_currentLine = LCD_LINE_1;
         } else 
         /* If cursor position locates on line 2 */
         {
             
             LCD_tmpDataBuffer = LCD_BEGINNING_OF_LINE_2_ADRESS + (LCD_cursorPosition - LCD_LINE_LENGTH);
-            LCD_currentLine = LCD_LINE_2;
         }
         LCD_WriteData(LCD_tmpDataBuffer >> HALF_OF_BYTE_LENTH);
         LCD_SET_ENABLE_SIGNAL;
@@ -461,32 +470,30 @@ void LCD_Run(void)
         LCD_delayCounter = 1u;
         break;
     case LCD_CHARACTER_WRITING_POINT:
-        LCD_SET_REGISTER_SELECT_SIGNAL;
-        /* If writing to line 1 is compleate */
-        if( (LCD_currentCharIndex >= LCD_LINE_LENGTH) && (LCD_currentLine == LCD_LINE_1) ) 
+        /* Only characters changed by the writers are sent, see 4-bit mode */
+        dirtyIdx = GW_Find_LCD_Dirty(LCD_currentCharIndex);
+        if(dirtyIdx == GW_LCD_NO_DIRTY_CHARACTER)
         {
-            /* Then we move corsor to position LCD_LINE_LENGTH (16, first position of line 2) */
-            LCD_cursorPosition = LCD_LINE_LENGTH;
-            LCD_currentPoint = LCD_SET_CURSOR_POSITION_POINT;
-        } else 
-        /* Or, if writing to line 1 and 2 is compleate */
-        if(LCD_currentCharIndex >= LCD_CURRENT_CHARACTERS_QUANTITY) 
+            /* Nothing changed, the state is checked again next tick */
+        } else
+        if(dirtyIdx != LCD_cursorPosition)
         {
-            /* Then we move cursor to position 0 (first position of line 1) */
-            LCD_nextPoint = LCD_CHARACTER_WRITING_POINT;
+            LCD_cursorPosition = dirtyIdx;
             LCD_currentPoint = LCD_SET_CURSOR_POSITION_POINT;
-            LCD_currentCharIndex = 0;
-            LCD_cursorPosition = 0;
-        } else 
-        /* Any other case means, that we still fill lines */
+        } else
         {
-            LCD_tmpDataBuffer = tmpString[LCD_currentCharIndex];
-            /*todo*/
+            GW_Clear_LCD_Dirty(dirtyIdx);
+            LCD_tmpDataBuffer = tmpString[dirtyIdx];
             LCD_WriteData(LCD_tmpDataBuffer);
             LCD_SET_REGISTER_SELECT_SIGNAL;
             LCD_SET_ENABLE_SIGNAL;
-            LCD_currentCharIndex++;
-        
+
+            LCD_cursorPosition++;
+            if( (LCD_cursorPosition % LCD_LINE_LENGTH) == 0u )
+            {
+                LCD_cursorPosition = LCD_CURSOR_UNKNOWN;
+            }
+            LCD_currentCharIndex = dirtyIdx + 1u;
             LCD_nextPoint = LCD_CHARACTER_WRITING_POINT;
             LCD_currentPoint = LCD_DELAY_POINT;
             LCD_delayCounter = 1u;
@@ -504,7 +511,9 @@ void LCD_Run(void)
         LCD_CLEAR_REGISTER_SELECT_SIGNAL;
         LCD_WriteData(LCD_CLEAR_DISPAY_CMD); // <----
         LCD_SET_ENABLE_SIGNAL;
+        GW_Mark_LCD_Dirty();
         LCD_currentCharIndex = 0;
+        LCD_cursorPosition = LCD_CURSOR_UNKNOWN;
 
         LCD_currentPoint = LCD_DELAY_POINT;
         LCD_delayCounter = 2u;
@@ -521,12 +530,10 @@ void LCD_Run(void)
         if( LCD_cursorPosition < LCD_LINE_LENGTH ) 
         {
             LCD_WriteData(LCD_BEGINNING_OF_LINE_1_ADRESS + LCD_cursorPosition);
-            LCD_currentLine = LCD_LINE_1;
         } else 
         /* If cursor position locates on line 2 */
         {
             LCD_WriteData(LCD_BEGINNING_OF_LINE_2_ADRESS + (LCD_cursorPosition - LCD_LINE_LENGTH));
-            LCD_currentLine = LCD_LINE_2;
         }
         LCD_SET_ENABLE_SIGNAL;
         LCD_nextPoint = LCD_CHARACTER_WRITING_POINT;
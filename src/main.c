@@ -16,6 +16,11 @@
 #include "oled/oled.h"
 #include "errortolcd/errortolcd.h"
 #include "twsi/twsi.h"
+#include "softuart/softuart.h"
+#include "telemetry/telemetry.h"
+#include "script/script.h"
+#include "job/job.h"
+#include "memaccess/memaccess.h"
 #include <avr/pgmspace.h>
 
 #include <util/delay.h>
@@ -29,7 +34,14 @@ int main(void)
 	BLK_Init();
 	//SM_Init();
 	UART_Init();
+#ifdef SUART_ENABLED
+	SUART_Init();
+#endif
 	BZ_Init();
+	ADC_Init();
+	TLM_Init();
+	SCR_Init();
+	JOB_Init();
 
 	DIO_ConfigurePin(LED_0, CP_C, CP_7, CP_I, CP_OFF, CP_WR);
 	DIO_ConfigurePin(LED_1, CP_C, CP_6, CP_I, CP_OFF, CP_WR);
@@ -51,7 +63,7 @@ int main(void)
 		}
 		if(TT_Event5ms == EVENT_ARRIVE) 
 		{
-			
+			ADC_NextChannel();
 			TT_Event5ms = EVENT_WAIT;
 		}
 		if(TT_Event10ms == EVENT_ARRIVE) 
@@ -60,7 +72,10 @@ int main(void)
 			BZ_Run();
 			//SM_Run();
 			CMD_Run();
-			
+			TLM_Run();
+			SCR_Run();
+			JOB_Run();
+			MEM_Run();
 			TT_Event10ms = EVENT_WAIT;
 		}
 		if(TT_Event100ms == EVENT_ARRIVE) 
@@ -75,6 +90,7 @@ int main(void)
 		if(TT_Event1000ms == EVENT_ARRIVE) 
 		{
 			LCD_FillCurrentCharacters();
+			UART_ReportErrorCounters();
 			ETL_Run();
 			TT_Event1000ms = EVENT_WAIT;
 		}
@@ -0,0 +1,112 @@
+#include "memaccess.h"
+
+#include <avr/eeprom.h>
+#include "../defines.h"
+#include "../utils/utils.h"
+#include "../uart/uart.h"
+#include "../cmd/cmd.h"
+
+/* EEPROM byte write takes ~8.5 ms, so written bytes wait here */
+static uint8_t MEM_eepromData[MEM_MAX_WRITE_LENGTH];
+static uint16_t MEM_eepromAddress = 0u;
+static uint8_t MEM_eepromLength = 0u;
+static uint8_t MEM_eepromIdx = 0u;
+
+void MEM_CheckAccess(const uint8_t space, const uint16_t address, const uint8_t count, uint8_t *error)
+{
+	uint32_t end = (uint32_t)address + count;
+
+	if( (count == 0u) ||
+		((space == MEM_SPACE_SRAM) && (end > ((uint32_t)RAMEND + 1u))) ||
+		((space == MEM_SPACE_IO) && (end > MEM_IO_SIZE)) ||
+		((space == MEM_SPACE_EEPROM) && (end > ((uint32_t)E2END + 1u))) ||
+		(space >= MEM_SPACE_QUANTITY) )
+	{
+		(*error) = ERR_MEM_WRONG_ADDRESS;
+	} else
+	if( (space == MEM_SPACE_EEPROM) && (MEM_IsWriting() == D_TRUE) )
+	{
+		/* Reads would return bytes that are about to change */
+		(*error) = ERR_MEM_BUSY;
+	} else
+	{
+		/* Nothing to do */
+	}
+}
+
+uint8_t MEM_IsWriting(void)
+{
+	uint8_t retVal = D_FALSE;
+
+	if(MEM_eepromIdx < MEM_eepromLength)
+	{
+		retVal = D_TRUE;
+	}
+
+	return retVal;
+}
+
+void MEM_Run(void)
+{
+	if( (MEM_IsWriting() == D_TRUE) && eeprom_is_ready() )
+	{
+		eeprom_update_byte((uint8_t *)(uintptr_t)(MEM_eepromAddress + MEM_eepromIdx), MEM_eepromData[MEM_eepromIdx]);
+		MEM_eepromIdx++;
+	}
+}
+
+void MEM_Read(const uint8_t space, const uint16_t address, uint8_t dst[], const uint8_t count, uint8_t *error)
+{
+	uint8_t idx = 0u;
+
+	MEM_CheckAccess(space, address, count, error);
+	if( (*error) == ERR_NO_ERROR)
+	{
+		for(idx = 0u; idx < count; idx++)
+		{
+			switch(space)
+			{
+			case MEM_SPACE_SRAM:
+				dst[idx] = _SFR_MEM8(address + idx);
+				break;
+			case MEM_SPACE_IO:
+				dst[idx] = _SFR_MEM8(MEM_IO_OFFSET + address + idx);
+				break;
+			default:
+				dst[idx] = eeprom_read_byte((const uint8_t *)(uintptr_t)(address + idx));
+				break;
+			}
+		}
+	}
+}
+
+void MEM_Write(const uint8_t space, const uint16_t address, const uint8_t src[], const uint8_t count, uint8_t *error)
+{
+	uint8_t idx = 0u;
+
+	MEM_CheckAccess(space, address, count, error);
+	if( (*error) == ERR_NO_ERROR)
+	{
+		switch(space)
+		{
+		case MEM_SPACE_SRAM:
+			for(idx = 0u; idx < count; idx++)
+			{
+				_SFR_MEM8(address + idx) = src[idx];
+			}
+			break;
+		case MEM_SPACE_IO:
+			for(idx = 0u; idx < count; idx++)
+			{
+				_SFR_MEM8(MEM_IO_OFFSET + address + idx) = src[idx];
+			}
+			break;
+		default:
+			U_ArrCpy(MEM_eepromData, src, count);
+			MEM_eepromAddress = address;
+			MEM_eepromIdx = 0u;
+			MEM_eepromLength = count;
+			break;
+		}
+	}
+}
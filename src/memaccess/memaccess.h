@@ -0,0 +1,35 @@
+#ifndef memaccess_h
+#define memaccess_h
+
+#include <avr/io.h>
+#include "../cmd/cmd.h"
+#include "../stringmanager/stringmanager.h"
+
+/* Debug access to memory of the running firmware:
+     mrd<space 1 hex><address 4 hex><count 2 hex> - answers MRD and
+         2 hex digits per byte
+     mwr<space 1 hex><address 4 hex><data, 2 hex per byte>
+   Symbol addresses come from the ELF on the host side. SRAM and I/O
+   space are accessed at once. EEPROM bytes are written by MEM_Run one
+   per call, and until they are written EEPROM access answers _MEMBUSY_ */
+#define MEM_SPACE_SRAM 0u
+#define MEM_SPACE_IO 1u
+#define MEM_SPACE_EEPROM 2u
+#define MEM_SPACE_QUANTITY 3u
+
+/* Data space address of I/O register 0 and number of I/O registers */
+#define MEM_IO_OFFSET 0x20u
+#define MEM_IO_SIZE 0x40u
+
+/* Bytes of one mrd response (MRD tag and 2 hex per byte) and of one
+   mwr request (name, space, address and 2 hex per byte) */
+#define MEM_MAX_READ_LENGTH ((UART_MAX_BODY_LENGTH - CMD_COMMAND_LENGTH) / STR_8BIT_STRING_LENGTH)
+#define MEM_MAX_WRITE_LENGTH ((UART_MAX_BODY_LENGTH - (CMD_COMMAND_LENGTH + 1u + STR_16BIT_STRING_LENGTH)) / STR_8BIT_STRING_LENGTH)
+
+extern void MEM_Run(void);
+extern void MEM_CheckAccess(const uint8_t space, const uint16_t address, const uint8_t count, uint8_t *error);
+extern void MEM_Read(const uint8_t space, const uint16_t address, uint8_t dst[], const uint8_t count, uint8_t *error);
+extern void MEM_Write(const uint8_t space, const uint16_t address, const uint8_t src[], const uint8_t count, uint8_t *error);
+extern uint8_t MEM_IsWriting(void);
+
+#endif
@@ -187,6 +187,12 @@ static const uint8_t PROGMEM OLED_initSequence[OLED_INIT_SEQUENCE_LENGTH] = {
 
 static uint8_t OLED_twoByteSequence[OLED_TWO_BYTE_SEQUENCE_LENGTH] = {0, 0};
 
+/* Last request to the display, OLED_IsSettled tells when it is reached:
+   start when the first page is being drawn, the rest when TWI is idle */
+#define OLED_REQUEST_START 0u
+#define OLED_REQUEST_TWI 1u
+static uint8_t OLED_request = OLED_REQUEST_TWI;
+
 void OLED_Fill(const uint8_t *buffer);
 void OLED_ResetDrawingProgress(void);
 void OLED_SendTwoByteSequenceUnsecured(uint8_t controlByte, uint8_t dataByte);
@@ -198,6 +204,8 @@ void OLED_StopDrawing(uint8_t *error)
     {
         OLED_currentPoint = OLED_POINT_STOP;
         OLED_nextPoint = OLED_POINT_STOP;
+        /* Page transfer may be still in progress */
+        OLED_request = OLED_REQUEST_TWI;
     } else
     {
         (*error) = ERR_CMD_OLED_FAIL_TO_STOP;
@@ -210,6 +218,7 @@ void OLED_StartDrawing(uint8_t *error)
     {
         OLED_ResetDrawingProgress();
         OLED_currentPoint = OLED_POINT_SET_PAGE;
+        OLED_request = OLED_REQUEST_START;
     } else
     {
         (*error) = ERR_CMD_OLED_FAIL_TO_START;
@@ -300,6 +309,7 @@ void OLED_Run(void)
         /* and just start to drow */
 
         TWI_SendBlockT(OLED_ADDRESS, &OLED_buffer[OLED_pagesBufferBeginningIdx], OLED_WIDTH + 1u, TWI_SPACE_RAM);
+        OLED_request = OLED_REQUEST_TWI;
 
         OLED_pageIdx++;
 
@@ -344,8 +354,24 @@ void OLED_SendTwoByteSequenceSecured(uint8_t controlByte, uint8_t dataByte, uint
     if(TWI_IsBusy() == D_FALSE)
     {
         OLED_SendTwoByteSequenceUnsecured(controlByte, dataByte);
+        if(OLED_request != OLED_REQUEST_START)
+        {
+            OLED_request = OLED_REQUEST_TWI;
+        }
     } else 
     {
         (*error) = ERR_CMD_TWI_IS_BUSY;
     }
+}
+
+uint8_t OLED_IsSettled(uint8_t *error)
+{
+    uint8_t retVal = D_FALSE;
+
+    if( (OLED_request != OLED_REQUEST_START) && (TWI_IsBusy() == D_FALSE) )
+    {
+        retVal = D_TRUE;
+    }
+
+    return retVal;
 }
\ No newline at end of file
@@ -14,5 +14,7 @@ void OLED_Run(void);
 
 void OLED_StopDrawing(uint8_t *error);
 void OLED_StartDrawing(uint8_t *error);
+/* D_TRUE when the last start, stop or TWI sequence request is done */
+uint8_t OLED_IsSettled(uint8_t *error);
 
 #endif
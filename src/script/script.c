@@ -0,0 +1,312 @@
+#include "script.h"
+
+#include <avr/eeprom.h>
+#include <avr/pgmspace.h>
+#include "../defines.h"
+#include "../utils/utils.h"
+#include "../uart/uart.h"
+#include "../stringmanager/stringmanager.h"
+
+#define SCR_NO_SCRIPT 0xFFu
+
+/* Failed script is reported on UART_CH_LOG:
+   SCR, script name, status and record offset in hex */
+#define SCR_LOG_TAG_LENGTH 3u
+#define SCR_LOG_LENGTH (SCR_LOG_TAG_LENGTH + SCR_NAME_LENGTH + STR_8BIT_STRING_LENGTH + STR_8BIT_STRING_LENGTH)
+#define SCR_LOG_FORMAT "SCR%.3s%02X%02X"
+
+typedef struct
+{
+	uint8_t name[SCR_NAME_LENGTH];
+	/* 0 or erased (0xFF) EEPROM means empty slot */
+	uint8_t length;
+	uint8_t flags;
+} ts_SCR_Header;
+
+static ts_SCR_Header EEMEM SCR_headersEeprom[SCR_SLOT_QUANTITY];
+static uint8_t EEMEM SCR_dataEeprom[SCR_SLOT_QUANTITY][SCR_SLOT_SIZE];
+
+/* EEPROM byte write takes ~8.5 ms, so one chunk is queued and SCR_Run
+   starts the next byte write when EEPROM is ready */
+static uint8_t SCR_writeData[SCR_WRITE_CHUNK_LENGTH];
+static uint8_t *SCR_writeAddress = 0;
+static uint8_t SCR_writeLength = 0u;
+static uint8_t SCR_writeIdx = 0u;
+/* Slot whose header is invalidated before scw data is written */
+static uint8_t SCR_eraseSlot = SCR_NO_SCRIPT;
+
+static uint8_t SCR_runSlot = SCR_NO_SCRIPT;
+static ts_SCR_Header SCR_runHeader;
+static uint8_t SCR_runPosition = 0u;
+static uint8_t SCR_runDelay = 0u;
+
+typedef uint8_t ScrHeaderFitsWriteChunk[(sizeof(ts_SCR_Header) <= SCR_WRITE_CHUNK_LENGTH) ? 1 : -1];
+
+static uint8_t SCR_IsBusy(void);
+static uint8_t SCR_FindScript(const uint8_t name[]);
+static void SCR_CheckRecords(const uint8_t slot, const uint8_t length, uint8_t *error);
+static void SCR_Start(const uint8_t slot);
+static void SCR_Log(const uint8_t name[], const uint8_t error, const uint8_t position);
+
+void SCR_Init(void)
+{
+	uint8_t slot = 0u;
+	ts_SCR_Header header;
+
+	SCR_runSlot = SCR_NO_SCRIPT;
+	SCR_writeLength = 0u;
+	SCR_writeIdx = 0u;
+	SCR_eraseSlot = SCR_NO_SCRIPT;
+	/* The first valid autorun script starts at boot */
+	for(slot = 0u; (slot < SCR_SLOT_QUANTITY) && (SCR_runSlot == SCR_NO_SCRIPT); slot++)
+	{
+		eeprom_read_block(&header, &SCR_headersEeprom[slot], sizeof(ts_SCR_Header));
+		if( (header.length > 0u) && (header.length <= SCR_SLOT_SIZE) && ((header.flags & SCR_FLAG_AUTORUN) != 0u) )
+		{
+			SCR_Start(slot);
+		}
+	}
+}
+
+uint8_t SCR_IsBusy(void)
+{
+	uint8_t retVal = D_FALSE;
+
+	if( (SCR_writeIdx < SCR_writeLength) || (SCR_eraseSlot != SCR_NO_SCRIPT) )
+	{
+		retVal = D_TRUE;
+	}
+
+	return retVal;
+}
+
+uint8_t SCR_FindScript(const uint8_t name[])
+{
+	uint8_t retVal = SCR_NO_SCRIPT;
+	uint8_t slot = 0u;
+	ts_SCR_Header header;
+
+	for(slot = 0u; (slot < SCR_SLOT_QUANTITY) && (retVal == SCR_NO_SCRIPT); slot++)
+	{
+		eeprom_read_block(&header, &SCR_headersEeprom[slot], sizeof(ts_SCR_Header));
+		if( (header.length > 0u) && (header.length <= SCR_SLOT_SIZE) &&
+			(header.name[0] == name[0]) && (header.name[1] == name[1]) && (header.name[2] == name[2]) )
+		{
+			retVal = slot;
+		}
+	}
+
+	return retVal;
+}
+
+void SCR_CheckRecords(const uint8_t slot, const uint8_t length, uint8_t *error)
+{
+	uint8_t position = 0u;
+	uint8_t commandLength = 0u;
+
+	/* Records must fill the script exactly, so replay never reads garbage */
+	while( (position < length) && ((*error) == ERR_NO_ERROR) )
+	{
+		commandLength = 0u;
+		if( (length - position) > SCR_RECORD_HEADER_LENGTH )
+		{
+			commandLength = eeprom_read_byte(&SCR_dataEeprom[slot][position + 1u]);
+		}
+		if( (commandLength == 0u) || (commandLength > UART_MAX_BODY_LENGTH) ||
+			(commandLength > (length - position - SCR_RECORD_HEADER_LENGTH)) )
+		{
+			(*error) = ERR_SCR_WRONG_SCRIPT;
+		}
+		position += SCR_RECORD_HEADER_LENGTH + commandLength;
+	}
+}
+
+void SCR_Start(const uint8_t slot)
+{
+	eeprom_read_block(&SCR_runHeader, &SCR_headersEeprom[slot], sizeof(ts_SCR_Header));
+	SCR_runPosition = 0u;
+	SCR_runDelay = eeprom_read_byte(&SCR_dataEeprom[slot][0]);
+	SCR_runSlot = slot;
+}
+
+void SCR_Log(const uint8_t name[], const uint8_t error, const uint8_t position)
+{
+	/* One more byte for the terminating zero of STR_Format */
+	char body[SCR_LOG_LENGTH + 1u];
+	uint8_t length = STR_Format(body, sizeof(body), PSTR(SCR_LOG_FORMAT), (const char *)name, error, position);
+
+	/* Nobody may listen, so the log is dropped if channel is full */
+	(void)UART_TX_WriteUnsolicitedPackage(UART_CH_LOG, (uint8_t *)body, length);
+}
+
+void SCR_Run(void)
+{
+	uint8_t body[UART_MAX_BODY_LENGTH];
+	uint8_t name[SCR_NAME_LENGTH];
+	uint8_t length = 0u;
+	uint8_t recordPosition = 0u;
+	uint8_t commandCnt = 0u;
+	uint8_t error = ERR_NO_ERROR;
+
+	if( (SCR_IsBusy() == D_TRUE) && eeprom_is_ready() )
+	{
+		if(SCR_eraseSlot != SCR_NO_SCRIPT)
+		{
+			eeprom_write_byte(&SCR_headersEeprom[SCR_eraseSlot].length, 0u);
+			SCR_eraseSlot = SCR_NO_SCRIPT;
+		} else
+		{
+			eeprom_write_byte(&SCR_writeAddress[SCR_writeIdx], SCR_writeData[SCR_writeIdx]);
+			SCR_writeIdx++;
+		}
+	}
+
+	if( (SCR_runSlot != SCR_NO_SCRIPT) && (SCR_runDelay > 0u) )
+	{
+		SCR_runDelay--;
+	}
+	while( (SCR_runSlot != SCR_NO_SCRIPT) && (SCR_runDelay == 0u) && (commandCnt < SCR_COMMANDS_PER_RUN) )
+	{
+		recordPosition = SCR_runPosition;
+		length = 0u;
+		U_ArrCpy(name, SCR_runHeader.name, SCR_NAME_LENGTH);
+		error = ERR_NO_ERROR;
+
+		/* Records were checked by scd, but EEPROM may have changed since.
+		   Length byte is read only inside the script and the slot, and a
+		   record must still fit the body and the script */
+		if( (SCR_runHeader.length <= SCR_SLOT_SIZE) &&
+			(((uint16_t)recordPosition + SCR_RECORD_HEADER_LENGTH) < SCR_runHeader.length) )
+		{
+			length = eeprom_read_byte(&SCR_dataEeprom[SCR_runSlot][recordPosition + 1u]);
+		}
+		if( (length == 0u) || (length > sizeof(body)) ||
+			(((uint16_t)recordPosition + SCR_RECORD_HEADER_LENGTH + length) > SCR_runHeader.length) )
+		{
+			error = ERR_SCR_WRONG_SCRIPT;
+		} else
+		{
+			eeprom_read_block(body, &SCR_dataEeprom[SCR_runSlot][recordPosition + SCR_RECORD_HEADER_LENGTH], length);
+
+			/* State moves to the next record before the command is executed,
+			   so the command itself may start or stop a script */
+			SCR_runPosition += SCR_RECORD_HEADER_LENGTH + length;
+			if(SCR_runPosition >= SCR_runHeader.length)
+			{
+				SCR_runPosition = 0u;
+				if((SCR_runHeader.flags & SCR_FLAG_LOOP) == 0u)
+				{
+					SCR_runSlot = SCR_NO_SCRIPT;
+				}
+			}
+			if(SCR_runSlot != SCR_NO_SCRIPT)
+			{
+				SCR_runDelay = eeprom_read_byte(&SCR_dataEeprom[SCR_runSlot][SCR_runPosition]);
+			}
+
+			CMD_Execute(body, length, &error);
+		}
+		if(error != ERR_NO_ERROR)
+		{
+			/* Failed command did not change script state */
+			SCR_runSlot = SCR_NO_SCRIPT;
+			SCR_Log(name, error, recordPosition);
+		}
+		commandCnt++;
+	}
+}
+
+//ASK14scw00000056C65643031END
+void SCR_ExecWriteCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	uint8_t slot = (uint8_t)args->arg[0].value;
+	uint8_t offset = (uint8_t)args->arg[1].value;
+	uint8_t length = args->arg[2].length / STR_8BIT_STRING_LENGTH;
+
+	if( (SCR_IsBusy() == D_TRUE) || (SCR_runSlot != SCR_NO_SCRIPT) )
+	{
+		(*error) = ERR_SCR_BUSY;
+	} else
+	if( ((args->arg[2].length % STR_8BIT_STRING_LENGTH) != 0u) || (length > SCR_WRITE_CHUNK_LENGTH) ||
+		((offset + length) > SCR_SLOT_SIZE) )
+	{
+		(*error) = ERR_SCR_WRONG_SCRIPT;
+	} else
+	{
+		STR_HexDecode(SCR_writeData, args->arg[2].string, length, error);
+		if( (*error) == ERR_NO_ERROR)
+		{
+			/* Changed data may break the records, the slot is valid again
+			   only after scd checks them */
+			if(eeprom_read_byte(&SCR_headersEeprom[slot].length) != 0u)
+			{
+				SCR_eraseSlot = slot;
+			}
+			SCR_writeAddress = &SCR_dataEeprom[slot][offset];
+			SCR_writeIdx = 0u;
+			SCR_writeLength = length;
+		}
+	}
+}
+
+//ASK0Ascd0LED070END
+void SCR_ExecDefineCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	uint8_t slot = (uint8_t)args->arg[0].value;
+	ts_SCR_Header header;
+
+	if( (SCR_IsBusy() == D_TRUE) || (SCR_runSlot != SCR_NO_SCRIPT) )
+	{
+		(*error) = ERR_SCR_BUSY;
+	} else
+	if( (args->arg[2].value > SCR_SLOT_SIZE) || ((args->arg[3].value & ~SCR_FLAGS_MASK) != 0u) )
+	{
+		(*error) = ERR_SCR_WRONG_SCRIPT;
+	} else
+	{
+		/* Zero length erases the slot */
+		SCR_CheckRecords(slot, (uint8_t)args->arg[2].value, error);
+		if( (*error) == ERR_NO_ERROR)
+		{
+			U_ArrCpy(header.name, args->arg[1].string, SCR_NAME_LENGTH);
+			header.length = (uint8_t)args->arg[2].value;
+			header.flags = (uint8_t)args->arg[3].value;
+			U_ArrCpy(SCR_writeData, (const uint8_t*)&header, sizeof(ts_SCR_Header));
+			SCR_writeAddress = (uint8_t*)&SCR_headersEeprom[slot];
+			SCR_writeIdx = 0u;
+			SCR_writeLength = sizeof(ts_SCR_Header);
+		}
+	}
+}
+
+void SCR_CheckRunCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	/* Running script must not read EEPROM that is being written */
+	if(SCR_IsBusy() == D_TRUE)
+	{
+		(*error) = ERR_SCR_BUSY;
+	} else
+	if(SCR_FindScript(args->arg[0].string) == SCR_NO_SCRIPT)
+	{
+		(*error) = ERR_SCR_NOT_FOUND;
+	} else
+	{
+		/* Nothing to do */
+	}
+}
+
+//ASK06scrLEDEND
+void SCR_ExecRunCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	SCR_CheckRunCommand(args, error);
+	if( (*error) == ERR_NO_ERROR)
+	{
+		SCR_Start(SCR_FindScript(args->arg[0].string));
+	}
+}
+
+//ASK03scsEND
+void SCR_ExecStopCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	SCR_runSlot = SCR_NO_SCRIPT;
+}
@@ -0,0 +1,42 @@
+#ifndef script_h
+#define script_h
+
+#include <avr/io.h>
+#include "../cmd/cmd.h"
+#include "../stringmanager/stringmanager.h"
+
+/* Command scripts are kept in internal EEPROM, one script per slot.
+   Script is a list of records:
+     byte 0 - delay before the command in SCR_Run ticks (10 ms)
+     byte 1 - command body length
+     then command body, as it is sent in a frame (without the '@'
+     timestamp mark).
+   Commands are executed by the same handlers as received ones.
+
+   Host erases a slot with scd of zero length, uploads the script with
+   scw chunks and then scd writes the slot header, which makes the
+   script valid:
+     scd<slot><name 3 chars><length 2 hex><flags 1 hex>
+     scw<slot><offset 2 hex><data, 2 hex per byte>
+     scr<name 3 chars> - runs the script, scs - stops it */
+
+#define SCR_SLOT_QUANTITY 4u
+#define SCR_SLOT_SIZE 128u
+#define SCR_NAME_LENGTH 3u
+#define SCR_RECORD_HEADER_LENGTH 2u
+
+/* Slot header flags */
+#define SCR_FLAG_AUTORUN 0x01u
+#define SCR_FLAG_LOOP 0x02u
+#define SCR_FLAGS_MASK (SCR_FLAG_AUTORUN | SCR_FLAG_LOOP)
+
+/* Commands executed in one SCR_Run when there is no delay between them */
+#define SCR_COMMANDS_PER_RUN 4u
+
+/* Bytes of one scw frame: body is name, slot, offset and 2 hex per byte */
+#define SCR_WRITE_CHUNK_LENGTH ((UART_MAX_BODY_LENGTH - (CMD_COMMAND_LENGTH + 1u + STR_8BIT_STRING_LENGTH)) / STR_8BIT_STRING_LENGTH)
+
+extern void SCR_Init(void);
+extern void SCR_Run(void);
+
+#endif
@@ -1,5 +1,11 @@
 #include "signalgateway.h"
 #include "../defines.h"
+#include "../utils/utils.h"
+
+/* One bit per LCD character */
+#define GW_LCD_DIRTY_BYTES ((LCD_CURRENT_CHARACTERS_QUANTITY + BITS_IN_ONE_BYTE - 1u) / BITS_IN_ONE_BYTE)
+#define GW_LCD_DIRTY_BYTE(position) ((position) / BITS_IN_ONE_BYTE)
+#define GW_LCD_DIRTY_BIT(position) U_bitMasks[(position) % BITS_IN_ONE_BYTE]
 
 /* Start LED display value */
 uint16_t LD_ledDisplayValue = 9876;
@@ -9,6 +15,7 @@ int8_t TCK_currentSpeed = 0;
 uint16_t ADC_ChannelValues[ADC_CHANNEL_QUANTITY] = {0};
 
 uint8_t LCD_currentCharacters[LCD_CURRENT_CHARACTERS_QUANTITY] = {0};
+uint8_t LCD_dirtyCharacters[GW_LCD_DIRTY_BYTES] = {0};
 
 uint8_t ETL_errorBufferPointer = 0u;
 ts_ETL_ErrorLog ETL_errorBuffer[ETL_ERROR_BUFFER_LENGTH];
@@ -42,6 +49,66 @@ uint8_t* GW_Get_LCD_String(void)
     return LCD_currentCharacters;
 }
 
+void GW_Write_LCD_String(const uint8_t position, const uint8_t src[], const uint8_t length)
+{
+    uint8_t idx = 0u;
+    uint8_t absIdx = position;
+
+    for(idx = 0u; (idx < length) && (absIdx < LCD_CURRENT_CHARACTERS_QUANTITY); idx++)
+    {
+        /* Text that is already there marks nothing, e.g. the fill of
+           LCD_FillCurrentCharacters over characters still showing it */
+        if(LCD_currentCharacters[absIdx] != src[idx])
+        {
+            LCD_currentCharacters[absIdx] = src[idx];
+            LCD_dirtyCharacters[GW_LCD_DIRTY_BYTE(absIdx)] |= GW_LCD_DIRTY_BIT(absIdx);
+        }
+        absIdx++;
+    }
+}
+
+void GW_Mark_LCD_Dirty(void)
+{
+    uint8_t idx = 0u;
+
+    for(idx = 0u; idx < GW_LCD_DIRTY_BYTES; idx++)
+    {
+        LCD_dirtyCharacters[idx] = 0xFFu;
+    }
+}
+
+uint8_t GW_Find_LCD_Dirty(const uint8_t position)
+{
+    uint8_t retVal = GW_LCD_NO_DIRTY_CHARACTER;
+    uint8_t anyDirty = 0u;
+    uint8_t idx = 0u;
+    uint8_t absIdx = position;
+
+    /* Display without changes is the usual case, it is found at once */
+    for(idx = 0u; idx < GW_LCD_DIRTY_BYTES; idx++)
+    {
+        anyDirty |= LCD_dirtyCharacters[idx];
+    }
+    for(idx = 0u; (anyDirty != 0u) && (retVal == GW_LCD_NO_DIRTY_CHARACTER) && (idx < LCD_CURRENT_CHARACTERS_QUANTITY); idx++)
+    {
+        if(absIdx >= LCD_CURRENT_CHARACTERS_QUANTITY)
+        {
+            absIdx = 0u;
+        }
+        if( (LCD_dirtyCharacters[GW_LCD_DIRTY_BYTE(absIdx)] & GW_LCD_DIRTY_BIT(absIdx)) != 0u )
+        {
+            retVal = absIdx;
+        }
+        absIdx++;
+    }
+    return retVal;
+}
+
+void GW_Clear_LCD_Dirty(const uint8_t position)
+{
+    LCD_dirtyCharacters[GW_LCD_DIRTY_BYTE(position)] &= (uint8_t)~GW_LCD_DIRTY_BIT(position);
+}
+
 
 void GW_Push_ETL_errorBuffer(uint8_t object, uint8_t error, uint8_t data)
 {
@@ -14,6 +14,17 @@ extern void GW_Read_ADC_ChannelValue(uint16_t * dst, uint8_t idx);
 
 extern uint8_t* GW_Get_LCD_String(void);
 
+/* LCD characters are written through GW_Write_LCD_String, it marks the
+   characters that really change as dirty, so LCD_Run sends only them.
+   GW_Find_LCD_Dirty returns the first dirty character from position on,
+   wrapping around, or GW_LCD_NO_DIRTY_CHARACTER */
+#define GW_LCD_NO_DIRTY_CHARACTER 0xFFu
+
+extern void GW_Write_LCD_String(const uint8_t position, const uint8_t src[], const uint8_t length);
+extern void GW_Mark_LCD_Dirty(void);
+extern uint8_t GW_Find_LCD_Dirty(const uint8_t position);
+extern void GW_Clear_LCD_Dirty(const uint8_t position);
+
 typedef struct ETL_ErrorLog 
 {
     uint8_t object;
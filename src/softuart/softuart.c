@@ -0,0 +1,210 @@
+#include "softuart.h"
+
+#include <avr/interrupt.h>
+#include "../defines.h"
+#include "../utils/utils.h"
+#include "../dio/dio.h"
+
+#ifdef SUART_ENABLED
+
+/* Timer2 runs from F_CPU/8, one compare match per transmitted bit */
+#define SUART_TIMER2_PRESCALER 8UL
+#define SUART_OCR2 (uint8_t)( ( ( (F_CPU / SUART_TIMER2_PRESCALER) + (SUART_BAUD / 2) ) / SUART_BAUD ) - 1)
+
+/* Timer1 runs from F_CPU, so one bit is this many Timer1 ticks */
+#define SUART_BIT_TICKS (uint16_t)( (F_CPU + (SUART_BAUD / 2) ) / SUART_BAUD )
+/* Cycles spent between start bit edge and OCR1B setup in INT0 ISR */
+#define SUART_RX_EDGE_LATENCY 40u
+/* The first data bit is sampled in the middle, 1.5 bit after start edge */
+#define SUART_RX_FIRST_SAMPLE_TICKS (uint16_t)( SUART_BIT_TICKS + (SUART_BIT_TICKS / 2) - SUART_RX_EDGE_LATENCY )
+
+#define SUART_DATA_BITS 8u
+
+#define SUART_TX_BUFFER_MASK (SUART_TX_BUFFER_SIZE - 1u)
+#define SUART_RX_BUFFER_MASK (SUART_RX_BUFFER_SIZE - 1u)
+
+/* Bit states of transmitter: start bit, data bits 1..8, stop bit */
+#define SUART_TX_START_BIT 0u
+#define SUART_TX_STOP_BIT (SUART_DATA_BITS + 1u)
+
+/* Pins are touched directly from ISRs, DIO layer is too slow for bit timing */
+#define SUART_TX_PORT PORTD
+#define SUART_TX_BIT 3
+#define SUART_RX_PIN PIND
+#define SUART_RX_BIT 2
+
+volatile static uint8_t SUART_TX_buffer[SUART_TX_BUFFER_SIZE];
+volatile static uint8_t SUART_TX_readPos = 0u;
+volatile static uint8_t SUART_TX_writePos = 0u;
+volatile static uint8_t SUART_TX_busyState = D_FALSE;
+static uint8_t SUART_TX_shiftReg = 0u;
+static uint8_t SUART_TX_bitIdx = SUART_TX_START_BIT;
+
+volatile static uint8_t SUART_RX_buffer[SUART_RX_BUFFER_SIZE];
+volatile static uint8_t SUART_RX_readPos = 0u;
+volatile static uint8_t SUART_RX_writePos = 0u;
+static uint8_t SUART_RX_shiftReg = 0u;
+static uint8_t SUART_RX_bitIdx = 0u;
+
+void SUART_Init(void)
+{
+    /* TX idles high, RX is input with pull-up */
+    DIO_ConfigurePin(SUART_TX, CP_D, CP_3, CP_R, CP_ON, CP_WR);
+    DIO_ConfigurePin(SUART_RX, CP_D, CP_2, CP_R, CP_ON, CP_RD);
+
+    /* Timer2 in CTC mode, compare interrupt is enabled only while transmitting */
+    TCCR2 = 0u;
+    TCNT2 = 0u;
+    OCR2 = SUART_OCR2;
+    SET_BIT(TCCR2, WGM21);
+    CLR_BIT(TIMSK, OCIE2);
+    TCCR2 |= (0 << CS22) | (1 << CS21) | (0 << CS20);
+
+    /* Timer1 is free-running (see TT_Init), receiver uses only its compare B */
+    CLR_BIT(TIMSK, OCIE1B);
+
+    /* INT0 on falling edge - start bit */
+    SET_BIT(MCUCR, ISC01);
+    CLR_BIT(MCUCR, ISC00);
+    GIFR = (1 << INTF0);
+    SET_BIT(GICR, INT0);
+}
+
+uint8_t SUART_TX_WriteStr(const uint8_t chArr[], const uint8_t length)
+{
+    uint8_t idx = 0u;
+    uint8_t nextWritePos = 0u;
+    uint8_t sreg = 0u;
+
+    /* Append as much as fits, the rest is dropped */
+    for(idx = 0u; idx < length; idx++)
+    {
+        nextWritePos = (SUART_TX_writePos + 1u) & SUART_TX_BUFFER_MASK;
+        if(nextWritePos == SUART_TX_readPos)
+        {
+            break;
+        }
+        SUART_TX_buffer[SUART_TX_writePos] = chArr[idx];
+        SUART_TX_writePos = nextWritePos;
+    }
+
+    /* Wake transmitter up if it is idle, it stops itself when buffer is empty */
+    sreg = SREG;
+    cli();
+    if(SUART_TX_busyState == D_FALSE)
+    {
+        SUART_TX_busyState = D_TRUE;
+        SUART_TX_bitIdx = SUART_TX_START_BIT;
+        TCNT2 = 0u;
+        TIFR = (1 << OCF2);
+        SET_BIT(TIMSK, OCIE2);
+    }
+    SREG = sreg;
+
+    return idx;
+}
+
+uint8_t SUART_TX_Get_FreeSpace(void)
+{
+    /* One cell always stays empty, so full buffer differs from empty one */
+    return (uint8_t)( (SUART_TX_readPos - SUART_TX_writePos - 1u) & SUART_TX_BUFFER_MASK );
+}
+
+uint8_t SUART_RX_ReadArray(uint8_t *dst, const uint8_t length)
+{
+    uint8_t idx = 0u;
+
+    for(idx = 0u; (idx < length) && (SUART_RX_readPos != SUART_RX_writePos); idx++)
+    {
+        dst[idx] = SUART_RX_buffer[SUART_RX_readPos];
+        SUART_RX_readPos = (SUART_RX_readPos + 1u) & SUART_RX_BUFFER_MASK;
+    }
+
+    return idx;
+}
+
+ISR(TIMER2_COMP_vect)
+{
+    if(SUART_TX_bitIdx == SUART_TX_START_BIT)
+    {
+        if(SUART_TX_readPos != SUART_TX_writePos)
+        {
+            /* Next byte, start bit */
+            SUART_TX_shiftReg = SUART_TX_buffer[SUART_TX_readPos];
+            SUART_TX_readPos = (SUART_TX_readPos + 1u) & SUART_TX_BUFFER_MASK;
+            CLR_BIT(SUART_TX_PORT, SUART_TX_BIT);
+            SUART_TX_bitIdx++;
+        } else
+        {
+            /* Nothing more to send, line stays in idle (high) */
+            CLR_BIT(TIMSK, OCIE2);
+            SUART_TX_busyState = D_FALSE;
+        }
+    } else
+    if(SUART_TX_bitIdx < SUART_TX_STOP_BIT)
+    {
+        /* Data bits, LSB first */
+        if(SUART_TX_shiftReg & 1u)
+        {
+            SET_BIT(SUART_TX_PORT, SUART_TX_BIT);
+        } else
+        {
+            CLR_BIT(SUART_TX_PORT, SUART_TX_BIT);
+        }
+        SUART_TX_shiftReg >>= 1;
+        SUART_TX_bitIdx++;
+    } else
+    {
+        /* Stop bit lasts until the next compare match */
+        SET_BIT(SUART_TX_PORT, SUART_TX_BIT);
+        SUART_TX_bitIdx = SUART_TX_START_BIT;
+    }
+}
+
+ISR(INT0_vect)
+{
+    /* Start bit edge, further edges are of no interest until stop bit */
+    CLR_BIT(GICR, INT0);
+
+    OCR1B = TCNT1 + SUART_RX_FIRST_SAMPLE_TICKS;
+    TIFR = (1 << OCF1B);
+    SET_BIT(TIMSK, OCIE1B);
+
+    SUART_RX_bitIdx = 0u;
+    SUART_RX_shiftReg = 0u;
+}
+
+ISR(TIMER1_COMPB_vect)
+{
+    uint8_t nextWritePos = 0u;
+
+    if(SUART_RX_bitIdx < SUART_DATA_BITS)
+    {
+        /* Data bits, LSB first */
+        SUART_RX_shiftReg >>= 1;
+        if(READ_BIT(SUART_RX_PIN, SUART_RX_BIT))
+        {
+            SUART_RX_shiftReg |= 0x80u;
+        }
+        SUART_RX_bitIdx++;
+        OCR1B += SUART_BIT_TICKS;
+    } else
+    {
+        /* Stop bit, the byte is valid only if line is back high */
+        if(READ_BIT(SUART_RX_PIN, SUART_RX_BIT))
+        {
+            nextWritePos = (SUART_RX_writePos + 1u) & SUART_RX_BUFFER_MASK;
+            if(nextWritePos != SUART_RX_readPos)
+            {
+                SUART_RX_buffer[SUART_RX_writePos] = SUART_RX_shiftReg;
+                SUART_RX_writePos = nextWritePos;
+            }
+        }
+        CLR_BIT(TIMSK, OCIE1B);
+        /* Ready for the next start bit */
+        GIFR = (1 << INTF0);
+        SET_BIT(GICR, INT0);
+    }
+}
+
+#endif
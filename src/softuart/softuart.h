@@ -0,0 +1,33 @@
+#ifndef softuart_h
+#define softuart_h
+
+#include <avr/io.h>
+
+/* Second, interrupt driven serial channel on two DIO pins:
+   TX - PD3, bit timing by Timer2 compare match
+   RX - PD2 (INT0), start bit edge, bits sampled by Timer1 compare B
+   8 data bits, no parity, 1 stop bit.
+   It carries the telemetry and log channels when UART_SOFT_CHANNELS
+   is defined, see uart.h */
+
+/* Define SUART_ENABLED to build the software UART. The board has no
+   free pin for it: PD3 is LD_SEG_D of the LED display and the
+   BTN_TCK_SPEED_1_FRWD button, PD2 is LD_SEG_E and the
+   BTN_RESET_LED_DISPLAY_VALUE button. A build with the software UART
+   must not initialise the LED display or the buttons, otherwise the
+   module is left out and PD2, PD3, INT0, Timer1 compare B and Timer2
+   stay untouched */
+//#define SUART_ENABLED
+
+#define SUART_BAUD 38400UL
+
+/* Powers of 2, TX ring holds the longest telemetry frame */
+#define SUART_TX_BUFFER_SIZE 64u
+#define SUART_RX_BUFFER_SIZE 16u
+
+extern void SUART_Init(void);
+extern uint8_t SUART_TX_WriteStr(const uint8_t chArr[], const uint8_t length);
+extern uint8_t SUART_TX_Get_FreeSpace(void);
+extern uint8_t SUART_RX_ReadArray(uint8_t *dst, const uint8_t length);
+
+#endif
@@ -24,7 +24,7 @@ typedef struct
 	/* Current position (in passes) */
 	int16_t position;
 	/* Number of steps to be done */
-	int16_t stepsToBeDone;
+	uint16_t stepsToBeDone;
 } ts_SM_Motor;
 
 extern ts_SM_Motor motor;
@@ -1,22 +1,76 @@
 #include "stringmanager.h"
 
+#include <stdarg.h>
+#include <avr/pgmspace.h>
+
 #include "../signalgateway/signalgateway.h"
 #include "../defines.h"
 #include "../utils/utils.h"
 
-#define STR_NUMBER_STRING_LENGTH 5u
-#define STR_16_BIT_DIGIT_QUANTITY 5u
+/* Digits converted by the 32-bit part of the ladder, the rest is below 10000 */
+#define STR_32BIT_LADDER_DIGITS 6u
+#define STR_LOW_LADDER_DIGITS 3u
+#define STR_16BIT_TOP_POWER 10000u
+
+#define STR_POINT_CHARACTER '.'
 
 #define STR_BCD_DIGIT_MASK (uint32_t)15u
 #define STR_BCD_DIGIT_STEP 4u
 #define STR_BITS_IN_DEC 17
 #define STR_BITS_IN_BCD 20
 
-#define STR_MAX_NUMBER 99999
+#define STR_FORMAT_MARK '%'
+#define STR_FORMAT_PRECISION_MARK '.'
+#define STR_FORMAT_LONG_MARK 'l'
+#define STR_FORMAT_FLAG_LEFT (1u << 0)
+#define STR_FORMAT_FLAG_ZEROS (1u << 1)
+#define STR_FORMAT_FLAG_LONG (1u << 2)
+#define STR_FORMAT_FLAG_FLASH (1u << 3)
+/* Hex digits of uint32_t, upper case digit becomes lower case with this bit */
+#define STR_FORMAT_HEX_DIGITS 8u
+#define STR_LOWER_CASE_BIT 0x20u
 
 #define STR_HALF_BYTE_MASK 15u
 #define STR_HALF_BYTE_STEP 4u
 
+/* Set in StrHexValues entries of hex digit characters */
+#define STR_HEX_VALID 0x10u
+#define STR_HEX_VALUE(character, value) [(uint8_t)(character)] = (STR_HEX_VALID | (value))
+
+/* Destination of STR_Format, limit leaves room for the terminating zero */
+typedef struct
+{
+    char *dst;
+    uint8_t length;
+    uint8_t limit;
+} ts_STR_Output;
+
+/* Place values of the decimal digits for the subtraction ladder, the
+   most significant first */
+static const uint32_t PROGMEM StrPowersOfTen32[STR_32BIT_LADDER_DIGITS] = {
+    1000000000ul, 100000000ul, 10000000ul, 1000000ul, 100000ul, 10000ul
+};
+static const uint16_t PROGMEM StrPowersOfTen16[STR_LOW_LADDER_DIGITS] = {
+    1000u, 100u, 10u
+};
+
+/* Value of every character as hex digit, both cases. Characters which
+   are not hex digits are 0, so they lack STR_HEX_VALID */
+static const uint8_t PROGMEM StrHexValues[256] = {
+    STR_HEX_VALUE('0', 0x0u), STR_HEX_VALUE('1', 0x1u), STR_HEX_VALUE('2', 0x2u), STR_HEX_VALUE('3', 0x3u),
+    STR_HEX_VALUE('4', 0x4u), STR_HEX_VALUE('5', 0x5u), STR_HEX_VALUE('6', 0x6u), STR_HEX_VALUE('7', 0x7u),
+    STR_HEX_VALUE('8', 0x8u), STR_HEX_VALUE('9', 0x9u),
+    STR_HEX_VALUE('A', 0xAu), STR_HEX_VALUE('B', 0xBu), STR_HEX_VALUE('C', 0xCu),
+    STR_HEX_VALUE('D', 0xDu), STR_HEX_VALUE('E', 0xEu), STR_HEX_VALUE('F', 0xFu),
+    STR_HEX_VALUE('a', 0xAu), STR_HEX_VALUE('b', 0xBu), STR_HEX_VALUE('c', 0xCu),
+    STR_HEX_VALUE('d', 0xDu), STR_HEX_VALUE('e', 0xEu), STR_HEX_VALUE('f', 0xFu)
+};
+
+/* Characters of hex digits, upper case as the protocol uses */
+static const uint8_t PROGMEM StrHexDigits[STR_HALF_BYTE_MASK + 1u] = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+};
+
 /* https://my.eng.utah.edu/~nmcdonal/Tutorials/BCDTutorial/BCDConversion.html */
 uint32_t STR_16bitDecToBCD(uint32_t dec) 
 {
@@ -67,28 +121,63 @@ uint32_t STR_16bitDecToBCD(uint32_t dec)
     return retVal;
 }
 
+/* Part of the field inside the LCD string */
+static uint8_t STR_LCDFieldLength(const uint8_t position, const uint8_t length)
+{
+    uint8_t retVal = 0u;
+
+    if(position < LCD_CURRENT_CHARACTERS_QUANTITY)
+    {
+        retVal = LCD_CURRENT_CHARACTERS_QUANTITY - position;
+        if(length < retVal)
+        {
+            retVal = length;
+        }
+    }
+    return retVal;
+}
+
 void STR_WriteStringToLCD(const uint8_t lineId, const uint8_t position, const uint8_t length, const char *str)
 {
-    uint8_t *LCD_string = 0;
     uint8_t newPosition = position;
-    LCD_string = GW_Get_LCD_String();
     if(lineId == LCD_LINE_2) 
     {
         newPosition += LCD_LINE_LENGTH;
     }
-    STR_WriteStringToArray(str, (char*)LCD_string, newPosition, length);
+    GW_Write_LCD_String(newPosition, (const uint8_t*)str, length);
 }
 
+/* Number fields are formatted in a copy of the field, then only the
+   changed characters are written and marked for LCD_Run */
 void STR_WriteNumberToLCD(const uint8_t lineId, const uint8_t position, const uint8_t length, const uint8_t alignment, const uint8_t filling, const uint32_t number)
 {
-    uint8_t *LCD_string = 0;
+    char tmpField[LCD_CURRENT_CHARACTERS_QUANTITY];
+    uint8_t newPosition = position;
+    uint8_t fieldLength = 0u;
+    if(lineId == LCD_LINE_2) 
+    {
+        newPosition += LCD_LINE_LENGTH;
+    }
+    fieldLength = STR_LCDFieldLength(newPosition, length);
+    U_ArrCpy((uint8_t*)tmpField, &GW_Get_LCD_String()[newPosition], fieldLength);
+    STR_WriteNumberToArray(tmpField, 0u, fieldLength, alignment, filling, number);
+    GW_Write_LCD_String(newPosition, (const uint8_t*)tmpField, fieldLength);
+}
+
+void STR_WriteFixedToLCD(const uint8_t lineId, const uint8_t position, const uint8_t length, const uint8_t alignment, const uint8_t filling,
+                         const int32_t number, const uint8_t decimals, const char *unit)
+{
+    char tmpField[LCD_CURRENT_CHARACTERS_QUANTITY];
     uint8_t newPosition = position;
-    LCD_string = GW_Get_LCD_String();
+    uint8_t fieldLength = 0u;
     if(lineId == LCD_LINE_2) 
     {
         newPosition += LCD_LINE_LENGTH;
     }
-    STR_WriteNumberToArray((char*)LCD_string, newPosition, length, alignment, filling, number);
+    fieldLength = STR_LCDFieldLength(newPosition, length);
+    U_ArrCpy((uint8_t*)tmpField, &GW_Get_LCD_String()[newPosition], fieldLength);
+    STR_WriteFixedToArray(tmpField, 0u, fieldLength, alignment, filling, number, decimals, unit);
+    GW_Write_LCD_String(newPosition, (const uint8_t*)tmpField, fieldLength);
 }
 
 void STR_WriteStringToArray(const char src[], char dst[], const uint8_t position, const uint8_t length) 
@@ -102,193 +191,541 @@ void STR_WriteStringToArray(const char src[], char dst[], const uint8_t position
     }
 }
 
-void STR_NumberToString(char *str, const uint32_t number) 
+/* Writes 4 digits of number < 10000 */
+static void STR_LowDigitsToString(char *str, uint16_t number)
 {
-    uint8_t zeroChar = 0u;
-    int8_t idx = 0u;
-    uint8_t digitIdx = 0u;
-    uint32_t BCDvalue = 0u;
-    uint32_t newNumber = number;
+    uint8_t idx = 0u;
+    uint16_t power = 0u;
+    char digit = '0';
 
-    zeroChar = (uint8_t)'0';
-    if(number > STR_MAX_NUMBER)
+    /* Every digit is found by subtracting its place value until the rest
+       is smaller, so no division is needed: 8-bit AVR has no divider and
+       the library division takes hundreds of cycles */
+    for(idx = 0u; idx < STR_LOW_LADDER_DIGITS; idx++)
     {
-        newNumber = newNumber - (STR_MAX_NUMBER + 1) ;
+        power = pgm_read_word(&StrPowersOfTen16[idx]);
+        digit = '0';
+        while(number >= power)
+        {
+            number -= power;
+            digit++;
+        }
+        str[idx] = digit;
     }
-    BCDvalue = STR_16bitDecToBCD(newNumber);
+    str[STR_LOW_LADDER_DIGITS] = (char)number + '0';
+}
+
+void STR_16BitNumberToString(char *str, const uint16_t number)
+{
+    uint16_t rest = number;
+    char digit = '0';
 
-    for(idx = STR_16_BIT_DIGIT_QUANTITY - 1; idx >= 0; idx--)
+    /* Up to 6 subtractions of 10000, the rest fits the 4-digit ladder */
+    while(rest >= STR_16BIT_TOP_POWER)
     {
-        str[idx] = ( (uint32_t)( BCDvalue & (STR_BCD_DIGIT_MASK << digitIdx ) ) >> digitIdx ) + zeroChar;
-        digitIdx += STR_BCD_DIGIT_STEP;
+        rest -= STR_16BIT_TOP_POWER;
+        digit++;
     }
-
+    str[0] = digit;
+    STR_LowDigitsToString(&str[1], rest);
 }
 
+void STR_NumberToString(char *str, const uint32_t number) 
+{
+    uint8_t idx = 0u;
+    uint32_t rest = number;
+    uint32_t power = 0u;
+    char digit = '0';
+
+    if(number <= UINT16_MAX)
+    {
+        /* Most of displayed values are 16-bit, they skip 32-bit arithmetic */
+        for(idx = 0u; idx < (STR_32BIT_DEC_STRING_LENGTH - STR_16BIT_DEC_STRING_LENGTH); idx++)
+        {
+            str[idx] = '0';
+        }
+        STR_16BitNumberToString(&str[idx], (uint16_t)number);
+    } else
+    {
+        for(idx = 0u; idx < STR_32BIT_LADDER_DIGITS; idx++)
+        {
+            power = pgm_read_dword(&StrPowersOfTen32[idx]);
+            digit = '0';
+            while(rest >= power)
+            {
+                rest -= power;
+                digit++;
+            }
+            str[idx] = digit;
+        }
+        STR_LowDigitsToString(&str[STR_32BIT_LADDER_DIGITS], (uint16_t)rest);
+    }
+}
 
 void STR_WriteNumberToArray(char dst[], const uint8_t position, const uint8_t length, const uint8_t alignment, const uint8_t filling, const uint32_t number) 
 {
-    char tmpNumberString[STR_NUMBER_STRING_LENGTH] = {0};
+    char tmpNumberString[STR_32BIT_DEC_STRING_LENGTH] = {0};
     uint8_t zerosStrLength = 0u;
     uint8_t idx = 0u;
     uint8_t numberStrLength = 0u;
-    uint8_t modifiedPosition = position; 
-    uint8_t modifiedLength = length;
+    uint8_t numberStart = 0u;
+    uint8_t padLength = 0u;
 
-    /* Converting number to string, so we get something like 00XXX */
+    /* Converting number to string, so we get something like 00000XXXXX */
     STR_NumberToString(tmpNumberString, number);
 
-    /* Next we need to costumize our raw string */
-    /* To do this we firstly need to calculate lengths of zeros-filled and number-filled 
-       parts of string */
     /* Count zero ('0') charcaters in beginning of received string 
        in case if number is equal to 0, we need to let one zero character for number-filled part */
-    for(idx = 0u; (tmpNumberString[idx] == ( (uint8_t)'0') ) && (idx < (STR_NUMBER_STRING_LENGTH-1) ); idx++)
+    for(idx = 0u; (tmpNumberString[idx] == ( (uint8_t)'0') ) && (idx < (STR_32BIT_DEC_STRING_LENGTH-1) ); idx++)
     {
         zerosStrLength++;
     }
 
     /* Knowing length of zero-filled part, we can calculate number-filled part */
-    numberStrLength = STR_NUMBER_STRING_LENGTH - zerosStrLength;
+    numberStrLength = STR_32BIT_DEC_STRING_LENGTH - zerosStrLength;
+    numberStart = zerosStrLength;
 
-    /* Next begin costumizing */
-    /*todo*/
-    if(alignment == STR_ALIGNMENT_LEFT) 
+    if(numberStrLength > length)
     {
-        /* If we got STR_ALIGNMENT_LEFT and STR_FILLING_SPACES */
-        /*todo*/
-        if(filling == STR_FILLING_SPACES)
+        /* Cut off value would be misleading, the field shows overflow */
+        STR_FillArray(dst, position, length, STR_OVERFLOW_CHARACTER);
+    } else
+    {
+        /* Field may be wider than the longest number, padding fills the rest */
+        padLength = length - numberStrLength;
+        if(filling == STR_FILLING_ZEROS)
         {
-            /* Then we copy number-part to the beginnig of string */
-            for(idx = 0u; idx < numberStrLength; idx++) 
-            {
-                tmpNumberString[idx] = tmpNumberString[idx + zerosStrLength];
-            }
-            /* And fill unnesecessary spase from the left with chararacters ' ' */
-            for(idx = numberStrLength; idx < STR_NUMBER_STRING_LENGTH; idx++) 
+            /* To fill empty space from the right with zeros is not good idea,
+               so zeros always go in front and alignment does not matter */
+            STR_FillArray(dst, position, padLength, '0');
+            STR_WriteStringToArray(&tmpNumberString[numberStart], dst, position + padLength, numberStrLength);
+        } else
+        if(alignment == STR_ALIGNMENT_LEFT)
+        {
+            STR_WriteStringToArray(&tmpNumberString[numberStart], dst, position, numberStrLength);
+            /* STR_FILLING_NONE lets the rest of field untouched */
+            if(filling == STR_FILLING_SPACES)
             {
-                tmpNumberString[idx] = (uint8_t)' ';
+                STR_FillArray(dst, position + numberStrLength, padLength, ' ');
             }
-        } else 
-        /* If we got STR_ALIGNMENT_LEFT and STR_FILLING_ZEROS */
-        if(filling == STR_FILLING_ZEROS)
-        {
-            /* To fill empty spase from the rigth with zeros is not good idea 
-               so we don't do anything */
-        } else 
-        /* If we got STR_ALIGNMENT_LEFT and STR_FILLING_NONE */
-        if(filling == STR_FILLING_NONE)
+        } else
+        if(alignment == STR_ALIGNMENT_RIGHT)
         {
-            /* Then we need also copy number-part to the beginnig of string */
-            for(idx = 0u; idx < numberStrLength; idx++) 
+            if(filling == STR_FILLING_SPACES)
             {
-                tmpNumberString[idx] = tmpNumberString[idx + zerosStrLength];
+                STR_FillArray(dst, position, padLength, ' ');
             }
-            /* And just cut off unnesecessary space */
-            modifiedLength = numberStrLength;
-            
-        } else {
+            STR_WriteStringToArray(&tmpNumberString[numberStart], dst, position + padLength, numberStrLength);
+        } else
+        {
             /* Nothing to do */
         }
-        
+    }
+}
+
+void STR_FillArray(char dst[], const uint8_t position, const uint8_t length, const char character)
+{
+    uint8_t idx = 0u;
+
+    for(idx = 0u; idx < length; idx++)
+    {
+        dst[position + idx] = character;
+    }
+}
+
+/* Writes magnitude scaled by 10^decimals without leading zeros, returns
+   the length, at most STR_32BIT_DEC_STRING_LENGTH + 1 */
+static uint8_t STR_MagnitudeToString(char str[], const uint32_t magnitude, const uint8_t decimals)
+{
+    char tmpDigits[STR_32BIT_DEC_STRING_LENGTH];
+    uint8_t retVal = 0u;
+    uint8_t firstDigit = 0u;
+    uint8_t pointIdx = STR_32BIT_DEC_STRING_LENGTH;
+    uint8_t idx = 0u;
+
+    /* Scaled value is converted as integer, so no division is needed,
+       decimal point is just put in front of the last decimals digits */
+    STR_NumberToString(tmpDigits, magnitude);
+    if( (decimals > 0u) && (decimals < STR_32BIT_DEC_STRING_LENGTH) )
+    {
+        pointIdx = STR_32BIT_DEC_STRING_LENGTH - decimals;
+    }
+    /* Skip leading zeros, but keep one digit before the point */
+    for(firstDigit = 0u; (firstDigit < (pointIdx - 1u)) && (tmpDigits[firstDigit] == '0'); firstDigit++)
+    {
+        /* Nothing to do */
+    }
+
+    for(idx = firstDigit; idx < STR_32BIT_DEC_STRING_LENGTH; idx++)
+    {
+        if(idx == pointIdx)
+        {
+            str[retVal] = STR_POINT_CHARACTER;
+            retVal++;
+        }
+        str[retVal] = tmpDigits[idx];
+        retVal++;
+    }
+
+    return retVal;
+}
+
+uint8_t STR_FixedToString(char str[], const int32_t number, const uint8_t decimals, const char *unit)
+{
+    uint8_t retVal = 0u;
+    uint8_t idx = 0u;
+    uint32_t magnitude = (uint32_t)number;
+
+    /* Negation in unsigned arithmetic is also right for INT32_MIN */
+    if(number < 0)
+    {
+        magnitude = 0u - magnitude;
+        str[0] = STR_SIGN_CHARACTER;
+        retVal = 1u;
+    }
+    retVal += STR_MagnitudeToString(&str[retVal], magnitude, decimals);
+    for(idx = 0u; (unit != 0) && (unit[idx] != '\0') && (idx < STR_UNIT_MAX_LENGTH); idx++)
+    {
+        str[retVal] = unit[idx];
+        retVal++;
+    }
+
+    return retVal;
+}
+
+void STR_WriteFixedToArray(char dst[], const uint8_t position, const uint8_t length, const uint8_t alignment, const uint8_t filling,
+                           const int32_t number, const uint8_t decimals, const char *unit)
+{
+    char tmpString[STR_FIXED_STRING_LENGTH];
+    uint8_t textLength = STR_FixedToString(tmpString, number, decimals, unit);
+    uint8_t signLength = (number < 0);
+
+    if(textLength > length)
+    {
+        /* Cut off value would be misleading, the field shows overflow */
+        STR_FillArray(dst, position, length, STR_OVERFLOW_CHARACTER);
+    } else
+    if(filling == STR_FILLING_ZEROS)
+    {
+        /* Zeros go between the sign and the digits, field is full,
+           so alignment does not matter */
+        STR_WriteStringToArray(tmpString, dst, position, signLength);
+        STR_FillArray(dst, position + signLength, length - textLength, '0');
+        STR_WriteStringToArray(&tmpString[signLength], dst, position + signLength + (length - textLength), textLength - signLength);
     } else
     if(alignment == STR_ALIGNMENT_RIGHT)
     {
-        /* If we got STR_ALIGNMENT_RIGHT and STR_FILLING_SPACES */
         if(filling == STR_FILLING_SPACES)
         {
-            /* Then we just need to fill unnesecessary space with ' ' */
-            for(idx = 0u; idx < zerosStrLength; idx++) 
-            {
-                 tmpNumberString[idx] = (uint8_t)' ';
-            }
-        } else 
-        /* If we got STR_ALIGNMENT_RIGHT and STR_FILLING_ZEROS */
-        if(filling == STR_FILLING_ZEROS)
+            STR_FillArray(dst, position, length - textLength, ' ');
+        }
+        STR_WriteStringToArray(tmpString, dst, position + (length - textLength), textLength);
+    } else
+    {
+        STR_WriteStringToArray(tmpString, dst, position, textLength);
+        if(filling == STR_FILLING_SPACES)
         {
-            /* String is already styled with required reles
-               so we don't do anything */
-        } else 
-        /* If we got STR_ALIGNMENT_RIGHT and STR_FILLING_NONE */
-        if(filling == STR_FILLING_NONE)
+            STR_FillArray(dst, position + textLength, length - textLength, ' ');
+        }
+    }
+}
+
+void STR_WriteSignedToArray(char dst[], const uint8_t position, const uint8_t length, const uint8_t alignment, const uint8_t filling, const int32_t number)
+{
+    STR_WriteFixedToArray(dst, position, length, alignment, filling, number, 0u, 0);
+}
+
+static void STR_OutputChar(ts_STR_Output *output, const char character)
+{
+    /* Text beyond capacity is dropped, the formatting goes on harmlessly */
+    if(output->length < output->limit)
+    {
+        output->dst[output->length] = character;
+        output->length++;
+    }
+}
+
+static void STR_OutputRepeat(ts_STR_Output *output, const char character, uint8_t count)
+{
+    for(; count > 0u; count--)
+    {
+        STR_OutputChar(output, character);
+    }
+}
+
+/* Writes text of textLength padded to width, text may be in flash. Zero
+   padding goes behind the first signLength characters */
+static void STR_OutputField(ts_STR_Output *output, const char *text, const uint8_t textLength, const uint8_t signLength,
+                            const uint8_t width, const uint8_t flags)
+{
+    uint8_t padding = 0u;
+    uint8_t idx = 0u;
+    char character = ' ';
+
+    if(width > textLength)
+    {
+        padding = width - textLength;
+    }
+    if( (flags & (STR_FORMAT_FLAG_LEFT | STR_FORMAT_FLAG_ZEROS)) == 0u )
+    {
+        STR_OutputRepeat(output, ' ', padding);
+    }
+    for(idx = 0u; idx < textLength; idx++)
+    {
+        if( (idx == signLength) && ( (flags & STR_FORMAT_FLAG_ZEROS) != 0u ) )
         {
-            /* Then we need also copy number-part to the beginnig of string */
-            for(idx = 0u; idx < numberStrLength; idx++) 
+            STR_OutputRepeat(output, '0', padding);
+        }
+        character = text[idx];
+        if( (flags & STR_FORMAT_FLAG_FLASH) != 0u )
+        {
+            character = pgm_read_byte(&text[idx]);
+        }
+        STR_OutputChar(output, character);
+    }
+    if( (flags & STR_FORMAT_FLAG_LEFT) != 0u )
+    {
+        STR_OutputRepeat(output, ' ', padding);
+    }
+}
+
+uint8_t STR_Format(char dst[], const uint8_t capacity, const char *format, ...)
+{
+    ts_STR_Output output = {dst, 0u, 0u};
+    char tmpString[STR_FIXED_STRING_LENGTH];
+    const char *text = 0;
+    uint8_t textLength = 0u;
+    uint8_t signLength = 0u;
+    uint8_t flags = 0u;
+    uint8_t width = 0u;
+    uint8_t precision = 0u;
+    uint8_t hasPrecision = D_FALSE;
+    uint32_t value = 0u;
+    char character = pgm_read_byte(format);
+    va_list args;
+
+    if(capacity > 0u)
+    {
+        output.limit = capacity - 1u;
+    }
+    va_start(args, format);
+    while(character != '\0')
+    {
+        format++;
+        if(character != STR_FORMAT_MARK)
+        {
+            STR_OutputChar(&output, character);
+        } else
+        {
+            /* %[-|0][width][.precision][l]conversion */
+            flags = 0u;
+            width = 0u;
+            precision = 0u;
+            hasPrecision = D_FALSE;
+            character = pgm_read_byte(format++);
+            if(character == '-')
+            {
+                flags |= STR_FORMAT_FLAG_LEFT;
+                character = pgm_read_byte(format++);
+            } else
+            if(character == '0')
             {
-                tmpNumberString[idx] = tmpNumberString[idx + zerosStrLength];
+                flags |= STR_FORMAT_FLAG_ZEROS;
+                character = pgm_read_byte(format++);
+            } else
+            {
+                /* No flag */
             }
-            /* Shift string a bit to the rigth */
-            modifiedPosition = position + zerosStrLength;
-            /* And cut off unnesecessary space */
-            modifiedLength = numberStrLength;
-            
-        } else 
-        {
-            /* Nothing to do */
+            while( (character >= '0') && (character <= '9') )
+            {
+                width = (width * 10u) + (uint8_t)(character - '0');
+                character = pgm_read_byte(format++);
+            }
+            if(character == STR_FORMAT_PRECISION_MARK)
+            {
+                hasPrecision = D_TRUE;
+                character = pgm_read_byte(format++);
+                while( (character >= '0') && (character <= '9') )
+                {
+                    precision = (precision * 10u) + (uint8_t)(character - '0');
+                    character = pgm_read_byte(format++);
+                }
+            }
+            if(character == STR_FORMAT_LONG_MARK)
+            {
+                flags |= STR_FORMAT_FLAG_LONG;
+                character = pgm_read_byte(format++);
+            }
+
+            text = tmpString;
+            textLength = 0u;
+            signLength = 0u;
+            switch(character)
+            {
+            case 'd':
+                if( (flags & STR_FORMAT_FLAG_LONG) != 0u )
+                {
+                    value = (uint32_t)va_arg(args, int32_t);
+                } else
+                {
+                    value = (uint32_t)(int32_t)va_arg(args, int);
+                }
+                /* Negation in unsigned arithmetic is also right for INT32_MIN */
+                if( (int32_t)value < 0 )
+                {
+                    value = 0u - value;
+                    tmpString[0] = STR_SIGN_CHARACTER;
+                    signLength = 1u;
+                }
+                textLength = signLength + STR_MagnitudeToString(&tmpString[signLength], value, precision);
+                break;
+            case 'u':
+                if( (flags & STR_FORMAT_FLAG_LONG) != 0u )
+                {
+                    value = va_arg(args, uint32_t);
+                } else
+                {
+                    value = va_arg(args, unsigned int);
+                }
+                textLength = STR_MagnitudeToString(tmpString, value, precision);
+                break;
+            case 'x':
+            case 'X':
+                if( (flags & STR_FORMAT_FLAG_LONG) != 0u )
+                {
+                    value = va_arg(args, uint32_t);
+                } else
+                {
+                    value = va_arg(args, unsigned int);
+                }
+                /* Digits are written from the end of the buffer */
+                textLength = STR_FORMAT_HEX_DIGITS;
+                do
+                {
+                    textLength--;
+                    tmpString[textLength] = pgm_read_byte(&StrHexDigits[value & STR_HALF_BYTE_MASK]);
+                    if(character == 'x')
+                    {
+                        tmpString[textLength] |= STR_LOWER_CASE_BIT;
+                    }
+                    value >>= STR_HALF_BYTE_STEP;
+                } while(value != 0u);
+                text = &tmpString[textLength];
+                textLength = STR_FORMAT_HEX_DIGITS - textLength;
+                break;
+            case 'c':
+                tmpString[0] = (char)va_arg(args, int);
+                textLength = 1u;
+                break;
+            case 'S':
+                flags |= STR_FORMAT_FLAG_FLASH;
+                /* Fall through */
+            case 's':
+                text = va_arg(args, const char *);
+                /* Precision is the longest part of the string to write */
+                while( ( (hasPrecision == D_FALSE) || (textLength < precision) ) &&
+                       ( ( ( (flags & STR_FORMAT_FLAG_FLASH) != 0u ) ? pgm_read_byte(&text[textLength]) : text[textLength] ) != '\0' ) )
+                {
+                    textLength++;
+                }
+                /* Zeros are for numbers only */
+                flags &= (uint8_t)~STR_FORMAT_FLAG_ZEROS;
+                break;
+            case STR_FORMAT_MARK:
+                tmpString[0] = STR_FORMAT_MARK;
+                textLength = 1u;
+                break;
+            default:
+                /* Unknown conversion character is written as text next, end
+                   of format ends the loop */
+                format--;
+                break;
+            }
+            STR_OutputField(&output, text, textLength, signLength, width, flags);
         }
-    } else 
+        character = pgm_read_byte(format);
+    }
+    va_end(args);
+
+    if(capacity > 0u)
     {
-        /* Nothing to do */
+        dst[output.length] = '\0';
     }
 
-    STR_WriteStringToArray(tmpNumberString, dst, modifiedPosition, modifiedLength);
+    return output.length;
 }
 
 uint8_t STR_CharToHexDigit(const int8_t charact, uint8_t *error)
 {
-    uint8_t retVal = 0u;
+    uint8_t retVal = pgm_read_byte(&StrHexValues[(uint8_t)charact]);
 
-    if( (charact >= '0') && (charact <= '9') )
-    {
-        retVal = charact - '0';
-    } else
-    if( (charact >= 'A') && (charact <= 'F') )
-    {
-        retVal = (charact - 'A') + 10;
-    } else
+    if( (retVal & STR_HEX_VALID) == 0u)
     {
         (*error) = ERR_STR_WRONG_CHARACTER;
     }
 
-    return retVal;
+    return retVal & STR_HALF_BYTE_MASK;
 }
 
 int8_t STR_HexDigitToChar(const uint8_t hex, uint8_t *error)
 {
     int8_t retVal = 0u;
 
-    if( (hex >= 0x00) && (hex <= 0x09) )
-    {
-        retVal = hex + '0';
-    } else
-    if( (hex >= 0x0A) && (hex <= 0x0F) )
+    if(hex <= STR_HALF_BYTE_MASK)
     {
-        retVal = (hex - 0x0A) + 'A';
+        retVal = (int8_t)pgm_read_byte(&StrHexDigits[hex]);
     } else
     {
-        retVal = 0u;
         (*error) = ERR_STR_WRONG_HEX_DIGIT;
     }
 
     return retVal;
 }
 
-uint8_t STR_StringTo8BitHex(const uint8_t src[], uint8_t *error)
+void STR_HexDecode(uint8_t dst[], const uint8_t src[], const uint8_t length, uint8_t *error)
 {
     uint8_t idx = 0u;
-    uint8_t retVal = 0u;
+    uint8_t high = 0u;
+    uint8_t low = 0u;
+    uint8_t valid = STR_HEX_VALID;
 
-    for(idx = 0; idx < STR_8BIT_STRING_LENGTH; idx++)
+    for(idx = 0u; idx < length; idx++)
     {
-        retVal |= STR_CharToHexDigit( (uint8_t)src[idx], error);
+        high = pgm_read_byte(&StrHexValues[src[0]]);
+        low = pgm_read_byte(&StrHexValues[src[1]]);
+        /* Flag of one wrong character clears the flag of the whole
+           buffer, so it is checked only once after the loop */
+        valid &= high & low;
+        dst[idx] = (uint8_t)(high << STR_HALF_BYTE_STEP) | (low & STR_HALF_BYTE_MASK);
+        src += STR_8BIT_STRING_LENGTH;
+    }
+    if(valid == 0u)
+    {
+        (*error) = ERR_STR_WRONG_CHARACTER;
+    }
+}
 
-        if(idx < (STR_8BIT_STRING_LENGTH - 1) )
-        {
-            retVal <<= 4u; 
-        }
+void STR_HexEncode(uint8_t dst[], const uint8_t src[], const uint8_t length)
+{
+    uint8_t idx = 0u;
+
+    for(idx = 0u; idx < length; idx++)
+    {
+        dst[0] = pgm_read_byte(&StrHexDigits[src[idx] >> STR_HALF_BYTE_STEP]);
+        dst[1] = pgm_read_byte(&StrHexDigits[src[idx] & STR_HALF_BYTE_MASK]);
+        dst += STR_8BIT_STRING_LENGTH;
     }
-    if((*error) != ERR_NO_ERROR)
+}
+
+uint8_t STR_StringTo8BitHex(const uint8_t src[], uint8_t *error)
+{
+    uint8_t retVal = 0u;
+    uint8_t tmpError = ERR_NO_ERROR;
+
+    STR_HexDecode(&retVal, src, sizeof(retVal), &tmpError);
+    if(tmpError != ERR_NO_ERROR)
     {
+        (*error) = tmpError;
         retVal = 0u;
     }
 
@@ -297,47 +734,55 @@ uint8_t STR_StringTo8BitHex(const uint8_t src[], uint8_t *error)
 
 uint16_t STR_StringTo16BitHex(const uint8_t src[], uint8_t *error)
 {
-    uint8_t idx = 0u;
+    uint8_t tmpArr[sizeof(uint16_t)] = {0};
     uint16_t retVal = 0u;
+    uint8_t tmpError = ERR_NO_ERROR;
 
-    for(idx = 0; idx < STR_8BIT_STRING_LENGTH*2; idx++)
+    /* High byte goes first */
+    STR_HexDecode(tmpArr, src, sizeof(tmpArr), &tmpError);
+    if(tmpError != ERR_NO_ERROR)
     {
-        retVal |= STR_CharToHexDigit( (uint8_t)src[idx], error);
-
-        if(idx < ( (STR_8BIT_STRING_LENGTH*2) - 1) )
-        {
-            retVal <<= 4u; 
-        }
-    }
-    if((*error) != ERR_NO_ERROR)
+        (*error) = tmpError;
+    } else
     {
-        retVal = 0u;
+        retVal = ((uint16_t)tmpArr[0] << 8u) | tmpArr[1];
     }
 
     return retVal;
 }
 
-void STR_8BitHexToString(uint8_t dst[], const uint8_t hex)
+uint32_t STR_StringToHex(const uint8_t src[], const uint8_t digits, uint8_t *error)
 {
-    int8_t tmpArrIdx = 0u;
-    uint8_t byteStepIdx = 0u;
+    uint8_t idx = 0u;
     uint8_t digit = 0u;
-    uint8_t tmpArr[STR_8BIT_STRING_LENGTH] = {0};
-    /* Here this error variable plays role of placeholder,
-       we are shure that hex is valid, so no need to 
-       handle errors */
-    uint8_t error = ERR_NO_ERROR;
+    uint8_t valid = STR_HEX_VALID;
+    uint32_t retVal = 0u;
 
-    for(tmpArrIdx = (int8_t)STR_8BIT_STRING_LENGTH - 1; tmpArrIdx >= 0; tmpArrIdx--)
+    /* Up to STR_32BIT_STRING_LENGTH digits, the most significant first */
+    for(idx = 0; idx < digits; idx++)
     {
-        digit = (hex >> byteStepIdx) & STR_HALF_BYTE_MASK;
-
-        tmpArr[tmpArrIdx] = STR_HexDigitToChar(digit, &error);
-        byteStepIdx += STR_HALF_BYTE_STEP;
+        digit = pgm_read_byte(&StrHexValues[src[idx]]);
+        valid &= digit;
+        retVal <<= STR_HALF_BYTE_STEP;
+        retVal |= digit & STR_HALF_BYTE_MASK;
     }
-
-    if(error == ERR_NO_ERROR)
+    if(valid == 0u)
     {
-        U_ArrCpy(dst, tmpArr, STR_8BIT_STRING_LENGTH);   
+        (*error) = ERR_STR_WRONG_CHARACTER;
+        retVal = 0u;
     }
-}
\ No newline at end of file
+
+    return retVal;
+}
+
+void STR_8BitHexToString(uint8_t dst[], const uint8_t hex)
+{
+    STR_HexEncode(dst, &hex, sizeof(hex));
+}
+
+void STR_16BitHexToString(uint8_t dst[], const uint16_t hex)
+{
+    /* High byte goes first */
+    STR_8BitHexToString(&dst[0], (uint8_t)(hex >> 8u));
+    STR_8BitHexToString(&dst[STR_8BIT_STRING_LENGTH], (uint8_t)hex);
+}
@@ -11,20 +11,67 @@
 #define STR_FILLING_NONE 2
 
 #define STR_8BIT_STRING_LENGTH 2u
+#define STR_16BIT_STRING_LENGTH 4u
+#define STR_32BIT_STRING_LENGTH 8u
 
+/* Decimal digits of the largest uint16_t and uint32_t values */
+#define STR_16BIT_DEC_STRING_LENGTH 5u
+#define STR_32BIT_DEC_STRING_LENGTH 10u
+
+/* Longest unit suffix of fixed-point fields, e.g. "mV" */
+#define STR_UNIT_MAX_LENGTH 3u
+/* Sign, all digits of int32_t, decimal point and unit */
+#define STR_FIXED_STRING_LENGTH (1u + STR_32BIT_DEC_STRING_LENGTH + 1u + STR_UNIT_MAX_LENGTH)
+#define STR_SIGN_CHARACTER '-'
+#define STR_OVERFLOW_CHARACTER '*'
+
+/* Write the number as zero-filled decimal digits, STR_32BIT_DEC_STRING_LENGTH
+   and STR_16BIT_DEC_STRING_LENGTH characters, no terminating zero */
 extern void STR_NumberToString(char *str, const uint32_t number);
+extern void STR_16BitNumberToString(char *str, const uint16_t number);
 extern uint8_t STR_StringTo8BitHex(uint8_t const src[], uint8_t *error);
 extern uint16_t STR_StringTo16BitHex(const uint8_t src[], uint8_t *error);
+extern uint32_t STR_StringToHex(const uint8_t src[], const uint8_t digits, uint8_t *error);
 extern void STR_8BitHexToString(uint8_t dst[], const uint8_t hex);
+/* Buffer conversion between length bytes and 2*length hex digits, the high
+   nibble first. Decoding accepts both cases and sets error once for the
+   whole buffer, encoding writes upper case */
+extern void STR_HexDecode(uint8_t dst[], const uint8_t src[], const uint8_t length, uint8_t *error);
+extern void STR_HexEncode(uint8_t dst[], const uint8_t src[], const uint8_t length);
+extern void STR_16BitHexToString(uint8_t dst[], const uint16_t hex);
 
 extern uint8_t STR_CharToHexDigit(const int8_t charact, uint8_t *error);
 extern int8_t STR_HexDigitToChar(const uint8_t hex, uint8_t *error);
 
+extern void STR_FillArray(char dst[], const uint8_t position, const uint8_t length, const char character);
 extern void STR_WriteStringToArray(const char src[], char dst[], const uint8_t position, const uint8_t length);
+/* Unsigned number in a field of length characters, any length. If the
+   number does not fit, the field is filled with STR_OVERFLOW_CHARACTER */
 extern void STR_WriteNumberToArray(char dst[], const uint8_t position, const uint8_t length, const uint8_t alignment, const uint8_t filling, const uint32_t number);
 
+/* Signed fixed-point number: number is the value scaled by 10^decimals,
+   e.g. 2560 with 3 decimals and unit "V" is written as "2.560V". unit may
+   be 0. Zero filling goes between the sign and the digits. If the text
+   does not fit length, the field is filled with '*'. STR_FixedToString
+   writes just the text to str of STR_FIXED_STRING_LENGTH and returns its
+   length */
+extern uint8_t STR_FixedToString(char str[], const int32_t number, const uint8_t decimals, const char *unit);
+extern void STR_WriteFixedToArray(char dst[], const uint8_t position, const uint8_t length, const uint8_t alignment, const uint8_t filling,
+                                  const int32_t number, const uint8_t decimals, const char *unit);
+extern void STR_WriteSignedToArray(char dst[], const uint8_t position, const uint8_t length, const uint8_t alignment, const uint8_t filling, const int32_t number);
+
+/* printf-like formatting without heap, format is a flash string (PSTR).
+   Conversions are %[-|0][width][.precision][l](d|u|x|X|c|s|S|%): l takes
+   32-bit arguments, %S is a flash string, precision limits %s/%S length.
+   Unlike printf, precision of %d/%u is fixed-point decimals, e.g. 2560
+   with "%.3u" is "2.560". At most capacity - 1 characters and a
+   terminating zero are written, the number of characters is returned */
+extern uint8_t STR_Format(char dst[], const uint8_t capacity, const char *format, ...);
+
 extern void STR_WriteStringToLCD(const uint8_t lineId, const uint8_t position, const uint8_t length, const char *str);
 extern void STR_WriteNumberToLCD(const uint8_t lineId, const uint8_t position, const uint8_t length, const uint8_t alignment, const uint8_t filling, uint32_t number);
+extern void STR_WriteFixedToLCD(const uint8_t lineId, const uint8_t position, const uint8_t length, const uint8_t alignment, const uint8_t filling,
+                                const int32_t number, const uint8_t decimals, const char *unit);
 
 extern uint32_t STR_16bitDecToBCD(uint32_t dec);
 
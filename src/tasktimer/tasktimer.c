@@ -56,6 +56,18 @@
  */
 #define PERIOD_1000MS_PRESCALER 10
 
+/*
+ * \def: TIMESTAMP_TCNT1_SHIFT
+ * \brief: TCNT1 runs at F_CPU, so 64 counts make one TT_TIMESTAMP_TICK_US
+ */
+#define TIMESTAMP_TCNT1_SHIFT 6
+
+/*
+ * \def: TIMESTAMP_OVERFLOW_SHIFT
+ * \brief: The number of timestamp ticks in one Timer/Counter1 overflow, as a shift
+ */
+#define TIMESTAMP_OVERFLOW_SHIFT (16 - TIMESTAMP_TCNT1_SHIFT)
+
 /*
  * \def: uint8_t period1msCntr
  * \brief: The counter, that counts the number of interrupt actuations
@@ -121,12 +133,19 @@ uint8_t TT_Event100ms =   EVENT_WAIT;
  */
 uint8_t TT_Event1000ms =  EVENT_WAIT;
 
+/*
+ * \def: uint8_t timer1Overflows
+ * \brief: The counter of Timer/Counter1 overflows, extends TCNT1 for timestamps
+ */
+volatile static uint8_t timer1Overflows = 0u;
+
 /**
  * void TT_Init(void) 
  * \brief: 
  * 		Initializes timer		 
  * \description: 
- * 		This function Initializes task timer, 8-bit Timer/Counter0
+ * 		This function Initializes task timer, 8-bit Timer/Counter0, and
+ * 		starts free-running 16-bit Timer/Counter1
  * \return value:
  * 		No return value
  */
@@ -157,6 +176,59 @@ void TT_Init(void)
 
     /* Set Timer/Counter0 clock prescaler */
     TCCR0 |= (0 << CS02) | (1 << CS01) | (1 << CS00);
+
+    /* Timer/Counter1 is left free-running at F_CPU in normal mode. It is a
+       time base for modules that schedule their own compare interrupts
+       relative to TCNT1 (e.g. software UART receiver), so it is never
+       cleared or reloaded */
+    TCCR1A = 0u;
+    TCCR1B = 0u;
+    TCNT1 = 0u;
+    TCCR1B |= (0 << CS12) | (0 << CS11) | (1 << CS10);
+
+    /* Overflows are counted for timestamps */
+    SET_BIT(TIMSK, TOIE1);
+}
+
+/**
+ * uint16_t TT_GetTimestamp(void) 
+ * \brief: 
+ * 		Returns current time in TT_TIMESTAMP_TICK_US units
+ * \description: 
+ * 		Timestamp is built from TCNT1 extended by the overflow counter.
+ * 		Can be called from interrupts as well. Only differences of two
+ * 		timestamps have a meaning, they are valid up to ~262 ms
+ * \return value:
+ * 		Timestamp
+ */
+uint16_t TT_GetTimestamp(void)
+{
+    uint8_t sreg = 0u;
+    uint8_t overflows = 0u;
+    uint16_t counter = 0u;
+
+    sreg = SREG;
+    cli();
+    counter = TCNT1;
+    overflows = timer1Overflows;
+    /* Overflow which is not handled yet belongs to this reading,
+       if counter is already small */
+    if( (TIFR & (1 << TOV1)) && (counter < 0x8000u) )
+    {
+        overflows++;
+    }
+    SREG = sreg;
+
+    return ( (uint16_t)overflows << TIMESTAMP_OVERFLOW_SHIFT ) | (counter >> TIMESTAMP_TCNT1_SHIFT);
+}
+
+/*
+ * \def: ISR(TIMER1_OVF_vect) 
+ * \brief: Interrupt function, what actuates on Timer/Counter1 overflow
+ */
+ISR(TIMER1_OVF_vect) 
+{
+    timer1Overflows++;
 }
 
 /*
@@ -23,6 +23,14 @@ extern uint8_t TT_Event10ms;
 extern uint8_t TT_Event100ms;
 extern uint8_t TT_Event1000ms;
 
+/*
+ * \def: TT_TIMESTAMP_TICK_US
+ * \brief: Resolution of TT_GetTimestamp, in us. Timestamp wraps
+ *      every 65536 ticks (~262 ms)
+ */
+#define TT_TIMESTAMP_TICK_US 4u
+
 extern void TT_Init(void);
+extern uint16_t TT_GetTimestamp(void);
 
 #endif
\ No newline at end of file
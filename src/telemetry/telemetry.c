@@ -0,0 +1,149 @@
+#include "telemetry.h"
+
+#include <avr/eeprom.h>
+#include "../defines.h"
+#include "../uart/uart.h"
+#include "../signalgateway/signalgateway.h"
+
+#define TLM_VARINT_DATA_MASK 0x7Fu
+#define TLM_VARINT_CONTINUE 0x80u
+#define TLM_VARINT_DATA_BITS 7u
+
+/* Does not compile if the longest frame does not fit the TLM channel,
+   UART_TX_WriteChannelPackage would cut its body */
+typedef uint8_t TlmBodyFitsChannel[(TLM_MAX_BODY_LENGTH <= UART_CH_MAX_BODY_LENGTH(UART_TX_TLM_BUFFER_SIZE)) ? 1 : -1];
+
+static uint16_t TLM_previousValues[ADC_QUANTITY] = {0u};
+static uint8_t TLM_body[TLM_MAX_BODY_LENGTH];
+static uint8_t TLM_bodyLength = 0u;
+static uint8_t TLM_sampleCnt = 0u;
+static uint8_t TLM_sequence = 0u;
+static uint8_t TLM_framesToKeyframe = 0u;
+static uint8_t TLM_tickCnt = 0u;
+/* Erased EEPROM means off */
+static uint8_t EEMEM TLM_enabledEeprom = D_FALSE;
+static uint8_t TLM_enabled = D_FALSE;
+
+static uint16_t TLM_ZigZag(const int16_t value);
+static uint8_t TLM_PutVarint(uint8_t dst[], uint16_t value);
+static void TLM_StartFrame(void);
+
+void TLM_Init(void)
+{
+	/* The first frame is a keyframe */
+	TLM_framesToKeyframe = 0u;
+	TLM_sequence = 0u;
+	TLM_StartFrame();
+	TLM_enabled = D_FALSE;
+	if( (eeprom_read_byte(&TLM_enabledEeprom) == D_TRUE) && (UART_TX_IsUnsolicitedAllowed(UART_CH_TLM) == D_TRUE) )
+	{
+		TLM_enabled = D_TRUE;
+	}
+}
+
+void TLM_Set_Enabled(const uint8_t enabled)
+{
+	if( (enabled == D_TRUE) && (TLM_enabled == D_FALSE) )
+	{
+		/* Receiver may have missed everything before, so start with a keyframe */
+		TLM_framesToKeyframe = 0u;
+		TLM_tickCnt = 0u;
+		TLM_StartFrame();
+	}
+	TLM_enabled = enabled;
+	eeprom_update_byte(&TLM_enabledEeprom, enabled);
+}
+
+void TLM_CheckTelemetryCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	if( (args->arg[0].value == D_TRUE) && (UART_TX_IsUnsolicitedAllowed(UART_CH_TLM) == D_FALSE) )
+	{
+		(*error) = ERR_TLM_NOT_ON_BUS;
+	}
+}
+
+//ASK04tlm1END
+void TLM_ExecTelemetryCommand(const ts_CMD_Args *args, uint8_t *error)
+{
+	TLM_CheckTelemetryCommand(args, error);
+	if( (*error) == ERR_NO_ERROR)
+	{
+		TLM_Set_Enabled((uint8_t)args->arg[0].value);
+	}
+}
+
+uint16_t TLM_ZigZag(const int16_t value)
+{
+	/* Small negative and positive deltas both become small numbers:
+	   0, -1, 1, -2, 2 ... -> 0, 1, 2, 3, 4 ... */
+	return ( (uint16_t)value << 1u ) ^ (uint16_t)(value >> 15);
+}
+
+uint8_t TLM_PutVarint(uint8_t dst[], uint16_t value)
+{
+	uint8_t retVal = 0u;
+
+	/* Low 7 bits first, the highest bit shows that one more byte follows */
+	while(value > TLM_VARINT_DATA_MASK)
+	{
+		dst[retVal] = (uint8_t)(value & TLM_VARINT_DATA_MASK) | TLM_VARINT_CONTINUE;
+		value >>= TLM_VARINT_DATA_BITS;
+		retVal++;
+	}
+	dst[retVal] = (uint8_t)value;
+	retVal++;
+
+	return retVal;
+}
+
+void TLM_StartFrame(void)
+{
+	uint8_t channelIdx = 0u;
+
+	TLM_body[0] = TLM_sequence & TLM_SEQUENCE_MASK;
+	TLM_body[1] = ADC_QUANTITY;
+	if(TLM_framesToKeyframe == 0u)
+	{
+		/* Keyframe deltas are taken against zero */
+		TLM_body[0] |= TLM_KEYFRAME_FLAG;
+		for(channelIdx = 0u; channelIdx < ADC_QUANTITY; channelIdx++)
+		{
+			TLM_previousValues[channelIdx] = 0u;
+		}
+		TLM_framesToKeyframe = TLM_KEYFRAME_INTERVAL;
+	}
+	TLM_framesToKeyframe--;
+	TLM_bodyLength = TLM_HEADER_LENGTH;
+	TLM_sampleCnt = 0u;
+}
+
+void TLM_Run(void)
+{
+	uint8_t channelIdx = 0u;
+	uint16_t value = 0u;
+
+	TLM_tickCnt++;
+	if( (TLM_enabled == D_TRUE) && (TLM_tickCnt >= TLM_SAMPLE_PERIOD_TICKS) )
+	{
+		TLM_tickCnt = 0u;
+		for(channelIdx = 0u; channelIdx < ADC_QUANTITY; channelIdx++)
+		{
+			GW_Read_ADC_ChannelValue(&value, channelIdx);
+			TLM_bodyLength += TLM_PutVarint(&TLM_body[TLM_bodyLength], TLM_ZigZag( (int16_t)(value - TLM_previousValues[channelIdx]) ));
+			TLM_previousValues[channelIdx] = value;
+		}
+		TLM_sampleCnt++;
+
+		if(TLM_sampleCnt >= TLM_SAMPLES_PER_FRAME)
+		{
+			/* Deltas of the next frame would be useless if this one is lost,
+			   so the next one is a keyframe then */
+			if(UART_TX_WriteChannelPackage(UART_CH_TLM, TLM_body, TLM_bodyLength) == D_FALSE)
+			{
+				TLM_framesToKeyframe = 0u;
+			}
+			TLM_sequence++;
+			TLM_StartFrame();
+		}
+	}
+}
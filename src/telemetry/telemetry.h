@@ -0,0 +1,39 @@
+#ifndef telemetry_h
+#define telemetry_h
+
+#include <avr/io.h>
+#include "../adc/adc.h"
+#include "../cmd/cmd.h"
+
+/* ADC telemetry is sent on UART_CH_TLM. Frame body is binary:
+     byte 0 - bit 7 keyframe flag, bits 0-6 frame sequence number
+     byte 1 - number of channels in a sample
+     then samples, every one is a zigzag varint of the delta of each
+     channel against its previous sample.
+   Keyframe starts from zero, so its first sample holds absolute values,
+   delta frames continue from the last sample of the previous frame.
+   Telemetry is off until the tlm1 command turns it on, tlm0 turns it
+   off, the setting is kept in EEPROM. It can not be turned on in
+   UART_RS485_MODE, a node must not talk on the bus unasked, unless
+   UART_SOFT_CHANNELS moves telemetry to the software UART */
+
+/* TLM_Run is called every 10 ms */
+#define TLM_SAMPLE_PERIOD_TICKS 2u
+#define TLM_SAMPLES_PER_FRAME 8u
+#define TLM_KEYFRAME_INTERVAL 16u
+
+#define TLM_HEADER_LENGTH 2u
+#define TLM_KEYFRAME_FLAG 0x80u
+#define TLM_SEQUENCE_MASK 0x7Fu
+
+/* 7 bits per varint byte, zigzag of 10 bit delta fits 2 bytes.
+   Whole body must fit UART_CH_MAX_BODY_LENGTH(UART_TX_TLM_BUFFER_SIZE),
+   telemetry module does not compile otherwise */
+#define TLM_VARINT_MAX_LENGTH 2u
+#define TLM_MAX_BODY_LENGTH (TLM_HEADER_LENGTH + (TLM_SAMPLES_PER_FRAME * ADC_QUANTITY * TLM_VARINT_MAX_LENGTH))
+
+extern void TLM_Init(void);
+extern void TLM_Run(void);
+extern void TLM_Set_Enabled(const uint8_t enabled);
+
+#endif
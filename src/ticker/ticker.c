@@ -3,12 +3,19 @@
 #include "../dio/dio.h"
 #include "../defines.h"
 #include "../signalgateway/signalgateway.h"
+#include "../uart/uart.h"
 
 /*
  * \def: LED_QUANTITY
- * \brief: The quantity of leds to be used in the program
+ * \brief: The quantity of leds to be used in the program. In RS-485 mode
+ *      PC3 of RED_LED_2 drives RS485_DE of the transceiver (see uart.h),
+ *      so the ticker leaves that led out
  */
+#ifdef UART_RS485_MODE
+#define LED_QUANTITY 7
+#else
 #define LED_QUANTITY 8
+#endif
 
 /*
  * \def: LED_*
@@ -62,7 +69,9 @@ const uint8_t TCK_leds[LED_QUANTITY] = {
 	GREEN_LED_1,
 	RED_LED_1,
 	GREEN_LED_2,
+#ifndef UART_RS485_MODE
 	RED_LED_2,
+#endif
 	GREEN_LED_3,
 	RED_LED_3,
 	GREEN_LED_4,
@@ -118,7 +127,9 @@ void TCK_Init(void)
 	DIO_ConfigurePin(GREEN_LED_1, 	CP_C, CP_0, CP_I, CP_ON, CP_WR);
 	DIO_ConfigurePin(RED_LED_1, 	CP_C, CP_1, CP_I, CP_OFF, CP_WR);
 	DIO_ConfigurePin(GREEN_LED_2, 	CP_C, CP_2, CP_I, CP_OFF, CP_WR);
+#ifndef UART_RS485_MODE
 	DIO_ConfigurePin(RED_LED_2, 	CP_C, CP_3, CP_I, CP_OFF, CP_WR);
+#endif
 	DIO_ConfigurePin(GREEN_LED_3, 	CP_C, CP_4, CP_I, CP_OFF, CP_WR);
 	DIO_ConfigurePin(RED_LED_3,		CP_C, CP_5, CP_I, CP_OFF, CP_WR);
 	DIO_ConfigurePin(GREEN_LED_4, 	CP_C, CP_6, CP_I, CP_OFF, CP_WR);
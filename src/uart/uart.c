@@ -1,18 +1,69 @@
 #include "uart.h"
 
 #include <avr/interrupt.h>
+#include <avr/eeprom.h>
+#include <avr/pgmspace.h>
 #include "../defines.h"
 #include "../utils/utils.h"
 #include "../dio/dio.h"
+#include "../signalgateway/signalgateway.h"
+#include "../tasktimer/tasktimer.h"
+#include "../softuart/softuart.h"
 
 
 #define BOUD 250000
 #define UBRR (uint16_t)( ( ( (F_CPU / 16) / BOUD) ) - 1)
 
 
-volatile static uint8_t UART_TX_buffer[UART_TX_BUFFER_SIZE];
-volatile static uint8_t UART_TX_readPos = 0u;
-volatile static uint8_t UART_TX_writePos = 0u;
+/* TX queue of one virtual channel. Every frame in the ring is preceded
+   by its length, which is not transmitted, so ISR knows frame boundaries */
+typedef struct
+{
+	volatile uint8_t *buffer;
+	uint8_t size;
+	volatile uint8_t readPos;
+	volatile uint8_t writePos;
+} ts_UART_TxQueue;
+
+volatile static uint8_t UART_TX_cmdBuffer[UART_TX_CMD_BUFFER_SIZE];
+volatile static uint8_t UART_TX_tlmBuffer[UART_TX_TLM_BUFFER_SIZE];
+volatile static uint8_t UART_TX_logBuffer[UART_TX_LOG_BUFFER_SIZE];
+
+/* Index is the channel id and the priority, 0 is the highest one */
+static ts_UART_TxQueue UART_TX_queues[UART_CH_QUANTITY] = {
+	{ UART_TX_cmdBuffer, UART_TX_CMD_BUFFER_SIZE, 0u, 0u },
+	{ UART_TX_tlmBuffer, UART_TX_TLM_BUFFER_SIZE, 0u, 0u },
+	{ UART_TX_logBuffer, UART_TX_LOG_BUFFER_SIZE, 0u, 0u },
+};
+
+/* Queued frame length must not reach the flash frame bit of the prefix */
+typedef uint8_t UartTxFrameFitsPrefix[(UART_TX_CMD_BUFFER_SIZE <= UART_FRAME_PREFIX_FLASH) &&
+	(UART_TX_TLM_BUFFER_SIZE <= UART_FRAME_PREFIX_FLASH) && (UART_TX_LOG_BUFFER_SIZE <= UART_FRAME_PREFIX_FLASH) ? 1 : -1];
+
+#ifdef UART_SOFT_CHANNELS
+#ifndef SUART_ENABLED
+#error "UART_SOFT_CHANNELS needs the software UART, define SUART_ENABLED in softuart.h"
+#endif
+#define UART_IS_SOFT_CHANNEL(channel) ((channel) != UART_CH_CMD)
+/* Soft channel frame is written as a whole, so the longest one must fit */
+typedef uint8_t UartSoftFrameFitsBuffer[(UART_TX_TLM_BUFFER_SIZE <= SUART_TX_BUFFER_SIZE) &&
+	(UART_TX_LOG_BUFFER_SIZE <= SUART_TX_BUFFER_SIZE) ? 1 : -1];
+#else
+#define UART_IS_SOFT_CHANNEL(channel) D_FALSE
+#endif
+#ifdef UART_RS485_MODE
+#define UART_UNSOLICITED_ON_BUS D_FALSE
+#else
+#define UART_UNSOLICITED_ON_BUS D_TRUE
+#endif
+
+/* Channel and bytes left of the frame being transmitted */
+volatile static uint8_t UART_TX_currentChannel = UART_CH_CMD;
+volatile static uint8_t UART_TX_frameRemaining = 0u;
+/* Next byte of the frame being transmitted from flash, 0 for queued frame */
+static const uint8_t * volatile UART_TX_flashFrame = 0;
+/* Set while transmitter shifts out data, cleared by TXC when queues are empty */
+volatile static uint8_t UART_TX_busyState = D_FALSE;
 
 volatile static uint8_t UART_RX_buffer[UART_RX_BUFFER_SIZE];
 volatile static uint8_t UART_RX_readPos = 0u;
@@ -21,11 +72,72 @@ volatile static uint8_t UART_RX_busyState = UART_RX_FREE;
 
 volatile static uint16_t UART_RX_newDataLength = 0u;
 
+/* Time when the first byte and the '\n' of a frame were received
+   and if the frame came after broadcast address */
+typedef struct
+{
+	uint16_t start;
+	uint16_t complete;
+	uint8_t broadcast;
+} ts_UART_RxStamp;
+
+/* One entry per stored '\n', in the same order as lines in RX ring */
+volatile static ts_UART_RxStamp UART_RX_stampBuffer[UART_RX_STAMP_BUFFER_SIZE];
+volatile static uint8_t UART_RX_stampReadPos = 0u;
+volatile static uint8_t UART_RX_stampWritePos = 0u;
+volatile static uint16_t UART_RX_frameStartStamp = 0u;
+
+/* Line without a stamp: on the shared bus it is not known who was
+   addressed, so it is taken as broadcast and never answered */
+#ifdef UART_RS485_MODE
+#define UART_RX_UNSTAMPED_BROADCAST D_TRUE
+#else
+#define UART_RX_UNSTAMPED_BROADCAST D_FALSE
+#endif
+/* Bytes of the current line stored by the interrupt and read by fetch,
+   both sides stamp only lines of UART_RX_MIN_FRAME_LENGTH or longer */
+volatile static uint8_t UART_RX_lineLength = 0u;
+static uint8_t UART_RX_fetchLineLength = 0u;
+
+static uint8_t EEMEM UART_nodeAddressEeprom = UART_NODE_ADDRESS_DEFAULT;
+volatile static uint8_t UART_nodeAddress = UART_NODE_ADDRESS_DEFAULT;
+/* Shows if the last address byte was the broadcast one */
+volatile static uint8_t UART_RX_broadcastState = D_FALSE;
+
+volatile static uint8_t UART_errorCounters[UART_ERR_CNT_QUANTITY] = {0u};
+static uint8_t UART_reportedErrorCounters[UART_ERR_CNT_QUANTITY] = {0u};
+
+const static uint8_t UART_errorCounterEtlCodes[UART_ERR_CNT_QUANTITY] = {
+	ETL_UART_OVERRUN,
+	ETL_UART_FRAMING_ERROR,
+	ETL_UART_PARITY_ERROR,
+	ETL_UART_RING_OVERFLOW,
+	ETL_UART_BAD_FRAME,
+};
+
+/* Ring buffer content is moved here to parse packages from it */
+static uint8_t UART_RX_alignedBuffer[UART_RX_BUFFER_SIZE];
+static uint8_t UART_RX_alignedLength = 0u;
+static uint8_t UART_RX_alignedPos = 0u;
+/* Stamps of lines of the aligned buffer and the one of the last read package */
+static ts_UART_RxStamp UART_RX_alignedStamps[UART_RX_STAMP_BUFFER_SIZE];
+static uint8_t UART_RX_alignedStampQnt = 0u;
+static uint8_t UART_RX_packageStampIdx = 0u;
+
 const static uint8_t UART_startSeq[UART_START_SEQ_LENGTH] = {'A', 'S', 'K'};
 const static uint8_t UART_stopSeq[UART_STOP_SEQ_LENGTH] = {'E', 'N', 'D', '\n'};
 
-static void UART_TX_Append(const uint8_t ch);
+static void UART_TX_Append(ts_UART_TxQueue *queue, uint8_t *writePos, const uint8_t ch);
+static void UART_TX_WriteStr(ts_UART_TxQueue *queue, uint8_t *writePos, const uint8_t chArr[], const uint8_t length);
+static uint8_t UART_TX_Pop(ts_UART_TxQueue *queue);
+static void UART_TX_Publish(ts_UART_TxQueue *queue, const uint8_t writePos);
+static void UART_TX_SendNext(void);
 static uint8_t UART_RX_ReadChar(void);
+static uint8_t UART_TX_Get_FreeSpace(const ts_UART_TxQueue *queue);
+#ifdef UART_SOFT_CHANNELS
+static uint8_t UART_TX_WriteSoftPackage(const uint8_t channel, const uint8_t body[], const uint8_t bodyLength);
+#endif
+static void UART_IncrErrorCounter(const uint8_t counterId);
 
 
 uint16_t UART_Get_RX_newDataLength(void)
@@ -41,6 +153,44 @@ uint16_t UART_Get_RX_newDataLength(void)
 	return tmpNewDataLength;
 }
 
+void UART_IncrErrorCounter(const uint8_t counterId)
+{
+	/* Counters saturate, so a long run never wraps them back to small values */
+	if(UART_errorCounters[counterId] < UART_ERR_CNT_MAX)
+	{
+		UART_errorCounters[counterId]++;
+	}
+}
+
+uint8_t UART_Get_ErrorCounter(const uint8_t counterId)
+{
+	uint8_t retVal = 0u;
+
+	if(counterId < UART_ERR_CNT_QUANTITY)
+	{
+		retVal = UART_errorCounters[counterId];
+	}
+
+	return retVal;
+}
+
+void UART_ReportErrorCounters(void)
+{
+	uint8_t counterIdx = 0u;
+	uint8_t tmpCounter = 0u;
+
+	/* Push to ETL only counters that changed since last report */
+	for(counterIdx = 0u; counterIdx < UART_ERR_CNT_QUANTITY; counterIdx++)
+	{
+		tmpCounter = UART_errorCounters[counterIdx];
+		if(tmpCounter != UART_reportedErrorCounters[counterIdx])
+		{
+			GW_Push_ETL_errorBuffer(ETL_UART_OBJ, UART_errorCounterEtlCodes[counterIdx], tmpCounter);
+			UART_reportedErrorCounters[counterIdx] = tmpCounter;
+		}
+	}
+}
+
 void UART_Init(void)
 {
     /* Set initial values */
@@ -58,33 +208,155 @@ void UART_Init(void)
     /* Set frame format: 8data, 2stop bit */
     UCSRC = (1<<URSEL) | (1<<USBS) | (3<<UCSZ0);
 
+    UART_nodeAddress = eeprom_read_byte(&UART_nodeAddressEeprom);
+    if( (UART_nodeAddress == UART_NODE_ADDRESS_ERASED) || (UART_nodeAddress == UART_BROADCAST_ADDRESS) )
+    {
+        UART_nodeAddress = UART_NODE_ADDRESS_DEFAULT;
+    }
+#ifdef UART_RS485_MODE
+    /* Driver is enabled only while we transmit */
+    DIO_ConfigurePin(RS485_DE, CP_C, CP_3, CP_R, CP_OFF, CP_WR);
+    /* 9 data bits, the 9th one marks address byte */
+    UCSRB |= (1<<UCSZ2);
+    /* Wait for address byte */
+    UCSRA |= (1<<MPCM);
+#endif
 }
 
-void UART_TX_Append(const uint8_t ch) 
+uint8_t UART_Get_NodeAddress(void)
 {
-    /* Write character to the currern position of TX buffer */
-	UART_TX_buffer[UART_TX_writePos] = ch;
+	return UART_nodeAddress;
+}
 
-    /* And move index to the next position */
-	UART_TX_writePos++;
-	if(UART_TX_writePos >= UART_TX_BUFFER_SIZE) {
-		UART_TX_writePos = 0u;
+void UART_Set_NodeAddress(const uint8_t address, uint8_t *error)
+{
+	if( (address == UART_NODE_ADDRESS_ERASED) || (address == UART_BROADCAST_ADDRESS) )
+	{
+		(*error) = ERR_UART_WRONG_NODE_ADDRESS;
+	} else
+	{
+		/* Takes effect with the next address byte */
+		UART_nodeAddress = address;
+		eeprom_update_byte(&UART_nodeAddressEeprom, address);
 	}
 }
 
-void UART_TX_WriteStr(const uint8_t chArr[], const uint8_t length) 
+uint8_t UART_RX_IsBroadcast(void)
 {
-    uint8_t idx = 0u;
-    /* Append the whole input array to TX buffer */
+	uint8_t retVal = UART_RX_UNSTAMPED_BROADCAST;
+
+	/* Tells about the last read package */
+	if(UART_RX_packageStampIdx < UART_RX_alignedStampQnt)
+	{
+		retVal = UART_RX_alignedStamps[UART_RX_packageStampIdx].broadcast;
+	}
+
+	return retVal;
+}
+
+void UART_TX_Append(ts_UART_TxQueue *queue, uint8_t *writePos, const uint8_t ch) 
+{
+	/* Write character to the local write position, ISR does not see it
+	   until the whole frame is written and the position is published */
+	queue->buffer[(*writePos)] = ch;
+
+	/* And move index to the next position */
+	(*writePos)++;
+	if((*writePos) >= queue->size) {
+		(*writePos) = 0u;
+	}
+}
+
+uint8_t UART_TX_Get_FreeSpace(const ts_UART_TxQueue *queue)
+{
+	uint8_t retVal = 0u;
+	uint8_t tmpReadPos = queue->readPos;
+	uint8_t tmpWritePos = queue->writePos;
+
+	/* One cell always stays empty, so full buffer differs from empty one */
+	if(tmpReadPos > tmpWritePos)
+	{
+		retVal = (tmpReadPos - tmpWritePos) - 1u;
+	} else
+	{
+		retVal = (queue->size - (tmpWritePos - tmpReadPos)) - 1u;
+	}
+
+	return retVal;
+}
+
+void UART_TX_WriteStr(ts_UART_TxQueue *queue, uint8_t *writePos, const uint8_t chArr[], const uint8_t length) 
+{
+	uint8_t idx = 0u;
+	/* Append the whole input array to TX queue */
 	for(idx = 0u; idx < length; idx++) 
-    {
-		UART_TX_Append(chArr[idx]);
+	{
+		UART_TX_Append(queue, writePos, chArr[idx]);
 	}
-    /* Make shore if UDR is ready to receive new data */
-	if(UCSRA & (1<<UDRE)) 
-    {
-        /* UDR assignment for TXC interrupt triggering */
-		UDR = 0u;
+}
+
+uint8_t UART_TX_Pop(ts_UART_TxQueue *queue)
+{
+	uint8_t retVal = 0u;
+
+	retVal = queue->buffer[queue->readPos];
+	queue->readPos++;
+	if(queue->readPos >= queue->size) 
+	{
+		queue->readPos = 0u;
+	}
+
+	return retVal;
+}
+
+/* Called with interrupts disabled only: from TXC or from the kick-off */
+void UART_TX_SendNext(void)
+{
+	uint8_t channelIdx = 0u;
+	uint8_t refIdx = 0u;
+	const uint8_t *frame = 0;
+
+	/* At frame boundary the highest priority non-empty queue is taken */
+	if(UART_TX_frameRemaining == 0u)
+	{
+		UART_TX_flashFrame = 0;
+		for(channelIdx = 0u; (UART_TX_frameRemaining == 0u) && (channelIdx < UART_CH_QUANTITY); channelIdx++)
+		{
+			if(UART_TX_queues[channelIdx].readPos != UART_TX_queues[channelIdx].writePos)
+			{
+				UART_TX_currentChannel = channelIdx;
+				UART_TX_frameRemaining = UART_TX_Pop(&UART_TX_queues[channelIdx]);
+			}
+		}
+		if( (UART_TX_frameRemaining & UART_FRAME_PREFIX_FLASH) != 0u )
+		{
+			UART_TX_frameRemaining &= (uint8_t)~UART_FRAME_PREFIX_FLASH;
+			for(refIdx = 0u; refIdx < UART_FLASH_FRAME_REF_LENGTH; refIdx++)
+			{
+				((uint8_t*)&frame)[refIdx] = UART_TX_Pop(&UART_TX_queues[UART_TX_currentChannel]);
+			}
+			UART_TX_flashFrame = frame;
+		}
+	}
+	if(UART_TX_frameRemaining > 0u)
+	{
+		UART_TX_busyState = D_TRUE;
+		if(UART_TX_flashFrame != 0)
+		{
+			UDR = pgm_read_byte(UART_TX_flashFrame);
+			UART_TX_flashFrame++;
+		} else
+		{
+			UDR = UART_TX_Pop(&UART_TX_queues[UART_TX_currentChannel]);
+		}
+		UART_TX_frameRemaining--;
+	} else
+	{
+		/* Stop bit of the last byte is out, line can be released */
+		UART_TX_busyState = D_FALSE;
+#ifdef UART_RS485_MODE
+		DIO_PinOff(RS485_DE);
+#endif
 	}
 }
 
@@ -121,123 +393,469 @@ void UART_RX_ReadArray(uint8_t *dst, const uint8_t length)
 	}
 }
 
-void UART_TX_WritePackage(const uint8_t body[], const uint8_t bodyLength)
+uint8_t UART_TX_WriteChannelPackage(const uint8_t channel, const uint8_t body[], const uint8_t bodyLength)
 {
+	ts_UART_TxQueue *queue = &UART_TX_queues[UART_CH_CMD];
 	uint8_t newBodyLength = bodyLength;
+	uint8_t frameLength = 0u;
+	uint8_t writePos = 0u;
 	uint8_t tmpArr[STR_8BIT_STRING_LENGTH] = {'0'};
+	uint8_t retVal = D_FALSE;
 
-	/* Cut body length if it is too big */
-	if(newBodyLength > UART_MAX_BODY_LENGTH) 
+	if(channel < UART_CH_QUANTITY)
+	{
+		queue = &UART_TX_queues[channel];
+	}
+	/* Cut body length if it is too big for the channel queue */
+	if(newBodyLength > UART_CH_MAX_BODY_LENGTH(queue->size)) 
 	{
-		newBodyLength = UART_MAX_BODY_LENGTH;
+		newBodyLength = UART_CH_MAX_BODY_LENGTH(queue->size);
 	}
-	/* Write start sequence */
-	UART_TX_WriteStr(UART_startSeq, UART_START_SEQ_LENGTH);
-	/* body length */
-	STR_8BitHexToString(tmpArr, newBodyLength);
-	UART_TX_WriteStr(tmpArr, STR_8BIT_STRING_LENGTH);
-	/* body */
-	UART_TX_WriteStr(body, newBodyLength);
-	/* and stop sequence */
-	UART_TX_WriteStr(UART_stopSeq, UART_STOP_SEQ_LENGTH);
+	frameLength = UART_START_SEQ_LENGTH + UART_CHANNEL_ID_LENGTH + UART_LENGTH_OF_BODY_LENGTH + newBodyLength + UART_STOP_SEQ_LENGTH;
+#ifdef UART_SOFT_CHANNELS
+	if(UART_IS_SOFT_CHANNEL(channel))
+	{
+		retVal = UART_TX_WriteSoftPackage(channel, body, newBodyLength);
+	} else
+#endif
+	/* Package is dropped as a whole if it does not fit, half of package
+	   would corrupt the one being transmitted */
+	if( UART_TX_Get_FreeSpace(queue) >= (UART_FRAME_PREFIX_LENGTH + frameLength) )
+	{
+		writePos = queue->writePos;
+		/* Frame length for ISR */
+		UART_TX_Append(queue, &writePos, frameLength);
+		/* Write start sequence */
+		UART_TX_WriteStr(queue, &writePos, UART_startSeq, UART_START_SEQ_LENGTH);
+		/* channel id */
+		UART_TX_Append(queue, &writePos, (uint8_t)('0' + channel));
+		/* body length */
+		STR_8BitHexToString(tmpArr, newBodyLength);
+		UART_TX_WriteStr(queue, &writePos, tmpArr, STR_8BIT_STRING_LENGTH);
+		/* body */
+		UART_TX_WriteStr(queue, &writePos, body, newBodyLength);
+		/* and stop sequence */
+		UART_TX_WriteStr(queue, &writePos, UART_stopSeq, UART_STOP_SEQ_LENGTH);
+
+		UART_TX_Publish(queue, writePos);
+		retVal = D_TRUE;
+	}
+
+	return retVal;
 }
 
-void UART_RX_ReadPackage(uint8_t body[], uint8_t *bodyLength, uint8_t *error)
+#ifdef UART_SOFT_CHANNELS
+uint8_t UART_TX_WriteSoftPackage(const uint8_t channel, const uint8_t body[], const uint8_t bodyLength)
+{
+	uint8_t channelId = (uint8_t)('0' + channel);
+	uint8_t tmpArr[STR_8BIT_STRING_LENGTH] = {'0'};
+	uint8_t retVal = D_FALSE;
+
+	/* The same frame as on the USART, written only as a whole */
+	if(SUART_TX_Get_FreeSpace() >= (UART_FRAME_HEADER_LENGTH + bodyLength + UART_STOP_SEQ_LENGTH))
+	{
+		STR_8BitHexToString(tmpArr, bodyLength);
+		(void)SUART_TX_WriteStr(UART_startSeq, UART_START_SEQ_LENGTH);
+		(void)SUART_TX_WriteStr(&channelId, UART_CHANNEL_ID_LENGTH);
+		(void)SUART_TX_WriteStr(tmpArr, STR_8BIT_STRING_LENGTH);
+		(void)SUART_TX_WriteStr(body, bodyLength);
+		(void)SUART_TX_WriteStr(UART_stopSeq, UART_STOP_SEQ_LENGTH);
+		retVal = D_TRUE;
+	}
+
+	return retVal;
+}
+#endif
+
+uint8_t UART_TX_IsUnsolicitedAllowed(const uint8_t channel)
+{
+	uint8_t retVal = D_FALSE;
+
+	/* Software UART is a line of its own, RS-485 bus is shared */
+	if( (UART_UNSOLICITED_ON_BUS == D_TRUE) || UART_IS_SOFT_CHANNEL(channel) )
+	{
+		retVal = D_TRUE;
+	}
+
+	return retVal;
+}
+
+uint8_t UART_TX_WriteUnsolicitedPackage(const uint8_t channel, const uint8_t body[], const uint8_t bodyLength)
+{
+	uint8_t retVal = D_TRUE;
+
+	/* Otherwise the node would collide with the one the master talks to,
+	   the frame is dropped as if it was sent, so the caller does not retry it */
+	if(UART_TX_IsUnsolicitedAllowed(channel) == D_TRUE)
+	{
+		retVal = UART_TX_WriteChannelPackage(channel, body, bodyLength);
+	}
+
+	return retVal;
+}
+
+uint8_t UART_TX_WriteFlashFrame(const uint8_t channel, const uint8_t *frame, const uint8_t frameLength)
+{
+	ts_UART_TxQueue *queue = &UART_TX_queues[UART_CH_CMD];
+	uint8_t writePos = 0u;
+	uint8_t retVal = D_FALSE;
+
+	if(channel < UART_CH_QUANTITY)
+	{
+		queue = &UART_TX_queues[channel];
+	}
+	/* Only the frame address is queued, ISR reads the frame from flash */
+	if( (frameLength < UART_FRAME_PREFIX_FLASH) &&
+		(UART_TX_Get_FreeSpace(queue) >= (UART_FRAME_PREFIX_LENGTH + UART_FLASH_FRAME_REF_LENGTH)) )
+	{
+		writePos = queue->writePos;
+		UART_TX_Append(queue, &writePos, UART_FRAME_PREFIX_FLASH | frameLength);
+		UART_TX_WriteStr(queue, &writePos, (const uint8_t*)&frame, UART_FLASH_FRAME_REF_LENGTH);
+		UART_TX_Publish(queue, writePos);
+		retVal = D_TRUE;
+	}
+
+	return retVal;
+}
+
+uint8_t UART_TX_IsRoomForPackage(const uint8_t channel, const uint8_t bodyLength)
+{
+	const ts_UART_TxQueue *queue = &UART_TX_queues[UART_CH_CMD];
+	uint8_t newBodyLength = bodyLength;
+	uint8_t retVal = D_FALSE;
+
+	if(channel < UART_CH_QUANTITY)
+	{
+		queue = &UART_TX_queues[channel];
+	}
+	/* The same cut as UART_TX_WriteChannelPackage does */
+	if(newBodyLength > UART_CH_MAX_BODY_LENGTH(queue->size))
+	{
+		newBodyLength = UART_CH_MAX_BODY_LENGTH(queue->size);
+	}
+	/* ISR only makes more room, so the answer stays true until the caller writes */
+	if( UART_TX_Get_FreeSpace(queue) >= (UART_FRAME_PREFIX_LENGTH + UART_FRAME_HEADER_LENGTH + newBodyLength + UART_STOP_SEQ_LENGTH) )
+	{
+		retVal = D_TRUE;
+	}
+
+	return retVal;
+}
+
+void UART_TX_Publish(ts_UART_TxQueue *queue, const uint8_t writePos)
+{
+	uint8_t sreg = 0u;
+
+	/* Publish the frame and start transmitter if it is idle */
+	sreg = SREG;
+	cli();
+	queue->writePos = writePos;
+	if(UART_TX_busyState == D_FALSE)
+	{
+#ifdef UART_RS485_MODE
+		DIO_PinOn(RS485_DE);
+#endif
+		UART_TX_SendNext();
+	}
+	SREG = sreg;
+}
+
+void UART_TX_WritePackage(const uint8_t body[], const uint8_t bodyLength)
+{
+	(void)UART_TX_WriteChannelPackage(UART_CH_CMD, body, bodyLength);
+}
+
+uint8_t UART_RX_FetchBuffer(void)
 {
 	uint8_t RX_bufferIdx = 0u;
-	uint8_t aligned_RX_buffer[UART_RX_BUFFER_SIZE] = {0u}; 
-	uint8_t seqIdx = 0u;
+	uint8_t fetchLength = 0u;
+	uint8_t ringLength = 0u;
+	uint8_t ringPos = UART_RX_readPos;
+	/* Interrupt may go on writing, bytes after this position wait */
+	uint8_t ringEnd = UART_RX_writePos;
 
+	/* Only complete lines are fetched, the start of a line that is still
+	   being received stays in the ring for the next run */
+	while(ringPos != ringEnd)
+	{
+		ringLength++;
+		if(UART_RX_buffer[ringPos] == '\n')
+		{
+			fetchLength = ringLength;
+		}
+		ringPos++;
+		if(ringPos == UART_RX_BUFFER_SIZE)
+		{
+			ringPos = 0u;
+		}
+	}
+	/* Full ring without a line end never completes, it is fetched as is */
+	if( (fetchLength == 0u) && (ringLength == (UART_RX_BUFFER_SIZE - 1u)) )
+	{
+		fetchLength = ringLength;
+	}
+
+	/* To easer work with rx buffer we convert ring-buffer to regular array-buffer */
+	UART_RX_alignedStampQnt = 0u;
+	for(RX_bufferIdx = 0u; RX_bufferIdx < fetchLength; RX_bufferIdx++)
+	{
+		UART_RX_alignedBuffer[RX_bufferIdx] = UART_RX_ReadChar();
+		if(UART_RX_fetchLineLength < UINT8_MAX)
+		{
+			UART_RX_fetchLineLength++;
+		}
+		/* Every line has its stamps, take them along. Lines too short for
+		   a frame have none, they get an empty entry, so the following
+		   lines keep their own stamps */
+		if(UART_RX_alignedBuffer[RX_bufferIdx] == '\n')
+		{
+			if(UART_RX_alignedStampQnt < UART_RX_STAMP_BUFFER_SIZE)
+			{
+				UART_RX_alignedStamps[UART_RX_alignedStampQnt].start = 0u;
+				UART_RX_alignedStamps[UART_RX_alignedStampQnt].complete = 0u;
+				UART_RX_alignedStamps[UART_RX_alignedStampQnt].broadcast = UART_RX_UNSTAMPED_BROADCAST;
+			}
+			if( (UART_RX_fetchLineLength >= UART_RX_MIN_FRAME_LENGTH) && (UART_RX_stampReadPos != UART_RX_stampWritePos) )
+			{
+				if(UART_RX_alignedStampQnt < UART_RX_STAMP_BUFFER_SIZE)
+				{
+					UART_RX_alignedStamps[UART_RX_alignedStampQnt].start = UART_RX_stampBuffer[UART_RX_stampReadPos].start;
+					UART_RX_alignedStamps[UART_RX_alignedStampQnt].complete = UART_RX_stampBuffer[UART_RX_stampReadPos].complete;
+					UART_RX_alignedStamps[UART_RX_alignedStampQnt].broadcast = UART_RX_stampBuffer[UART_RX_stampReadPos].broadcast;
+				}
+				UART_RX_stampReadPos = (UART_RX_stampReadPos + 1u) % UART_RX_STAMP_BUFFER_SIZE;
+			}
+			if(UART_RX_alignedStampQnt < UART_RX_STAMP_BUFFER_SIZE)
+			{
+				UART_RX_alignedStampQnt++;
+			}
+			UART_RX_fetchLineLength = 0u;
+		}
+	}
+	UART_RX_alignedLength = fetchLength;
+	UART_RX_alignedPos = 0u;
+
+	return fetchLength;
+}
+
+void UART_RX_Get_PackageTimestamps(uint16_t *rxStart, uint16_t *rxComplete)
+{
+	(*rxStart) = 0u;
+	(*rxComplete) = 0u;
+	if(UART_RX_packageStampIdx < UART_RX_alignedStampQnt)
+	{
+		(*rxStart) = UART_RX_alignedStamps[UART_RX_packageStampIdx].start;
+		(*rxComplete) = UART_RX_alignedStamps[UART_RX_packageStampIdx].complete;
+	}
+}
+
+uint8_t UART_RX_IsPackagePending(void)
+{
+	uint8_t RX_bufferIdx = 0u;
+	uint8_t retVal = D_FALSE;
+
+	/* Package is pending if there is one more start sequence in the rest of buffer,
+	   trailing bytes without it are just ignored */
+	for(RX_bufferIdx = UART_RX_alignedPos; 
+		(retVal == D_FALSE) && ( (RX_bufferIdx + UART_START_SEQ_LENGTH) <= UART_RX_alignedLength );
+		RX_bufferIdx++)
+	{
+		if(U_ArrCmp(&UART_RX_alignedBuffer[RX_bufferIdx], UART_startSeq, UART_START_SEQ_LENGTH) == 0)
+		{
+			UART_RX_alignedPos = RX_bufferIdx;
+			retVal = D_TRUE;
+		}
+	}
+
+	return retVal;
+}
+
+void UART_RX_ReadPackage(uint8_t body[], uint8_t *bodyLength, uint8_t *error)
+{
+	uint8_t RX_bufferIdx = 0u;
 	uint8_t startSeqFound = D_FALSE;
 	uint8_t stopSeqFound = D_FALSE;
 
 	uint8_t startSeqPos = 0u;
 	uint8_t bodyPos = 0u;
-	/* To easer work with rx buffer we convert ring-buffer to regular array-buffer */
-	for(RX_bufferIdx = 0; RX_bufferIdx < UART_RX_BUFFER_SIZE; RX_bufferIdx++)
+
+	(*bodyLength) = 0u;
+	/* The rirst thing we need to do is to find start sequence */
+	/* For each buffer position from where previous package ended,
+	   if there is still place for the shortest package */
+	for(RX_bufferIdx = UART_RX_alignedPos; 
+		(startSeqFound == D_FALSE) && ( (RX_bufferIdx + UART_START_SEQ_LENGTH + UART_LENGTH_OF_BODY_LENGTH + UART_STOP_SEQ_LENGTH) <= UART_RX_alignedLength );
+		RX_bufferIdx++)
 	{
-		aligned_RX_buffer[RX_bufferIdx] = UART_RX_ReadChar();
+		/* we compare part of buffer with start sequence */
+		if(U_ArrCmp(&UART_RX_alignedBuffer[RX_bufferIdx], UART_startSeq, UART_START_SEQ_LENGTH) == 0)
+		{
+			/* save sequence start position */
+			startSeqPos = RX_bufferIdx;
+			/* And rise the flag that shows we found this seq */
+			startSeqFound = D_TRUE;
+		}
 	}
-	//STR_WriteStringToLCD(LCD_LINE_2, 0, 16, (char*)aligned_RX_buffer);
-	/* The rirst thing we need to do is to find start sequence */
-	/* For each buffer position */
-	for(RX_bufferIdx = 0u; RX_bufferIdx < (UART_RX_BUFFER_SIZE - UART_START_SEQ_LENGTH); RX_bufferIdx++)
+	/* Package belongs to the line where its start sequence is,
+	   or where search began if there is no start sequence */
+	if(startSeqFound == D_FALSE)
+	{
+		startSeqPos = UART_RX_alignedPos;
+	}
+	UART_RX_packageStampIdx = 0u;
+	for(RX_bufferIdx = 0u; RX_bufferIdx < startSeqPos; RX_bufferIdx++)
 	{
-		/* we compare part of buffer matching with start sequence */
-		for(seqIdx = RX_bufferIdx; seqIdx < UART_START_SEQ_LENGTH; seqIdx++)
+		if(UART_RX_alignedBuffer[RX_bufferIdx] == '\n')
 		{
-			/* and if wi found it */
-			if( (U_ArrCmp(&aligned_RX_buffer[RX_bufferIdx], UART_startSeq, UART_START_SEQ_LENGTH) == 0) && (startSeqFound == D_FALSE) )
-			{
-				/* save sequence start position */
-				startSeqPos = RX_bufferIdx;
-				/* And rise the flag that shows we found this seq */
-				startSeqFound = D_TRUE;
-			}
+			UART_RX_packageStampIdx++;
 		}
 	}
 	/* If we found start sequence */
 	if(startSeqFound == D_TRUE)
 	{
 		/* then we can define body length thant goes rigth after start sequence */
-		(*bodyLength) = STR_StringTo8BitHex( &aligned_RX_buffer[startSeqPos + UART_START_SEQ_LENGTH], error);
-		/* If conversion was success */
-		if( (*error) == ERR_NO_ERROR)
+		(*bodyLength) = STR_StringTo8BitHex( &UART_RX_alignedBuffer[startSeqPos + UART_START_SEQ_LENGTH], error);
+		/* then we calculate body start position in rx buffer */
+		bodyPos = startSeqPos + UART_START_SEQ_LENGTH + UART_LENGTH_OF_BODY_LENGTH;
+		/* If conversion was success and whole package fits both buffers */
+		if( ( (*error) == ERR_NO_ERROR) && 
+			( (*bodyLength) <= (UART_MAX_BODY_LENGTH) ) &&
+			( (bodyPos + (*bodyLength) + UART_STOP_SEQ_LENGTH) <= UART_RX_alignedLength ) )
 		{
-			/* and if body has acceptable length */
-			if( (*bodyLength) < UART_MAX_BODY_LENGTH) 
+			/* We have eficient info to find stop sequence, so if we found it */
+			if( U_ArrCmp( &UART_RX_alignedBuffer[bodyPos + (*bodyLength)], UART_stopSeq, UART_STOP_SEQ_LENGTH ) == 0 )
 			{
-				/* then we calculate body start position in rx buffer */
-				bodyPos = startSeqPos + UART_START_SEQ_LENGTH + UART_LENGTH_OF_BODY_LENGTH;
-				/* We have eficient info to find stop sequence, so if we found it */
-				if( U_ArrCmp( &aligned_RX_buffer[bodyPos + (*bodyLength)], UART_stopSeq, UART_START_SEQ_LENGTH ) == 0 )
-				{
-					/* then rise the corresponding flag */
-					stopSeqFound = D_TRUE;
-				}
+				/* then rise the corresponding flag */
+				stopSeqFound = D_TRUE;
 			}
-		} 
+		}
 	}
 	//ASK101234567890ABCDEFEND
 	/* If stop sequence is found */ 
 	if( stopSeqFound == D_TRUE )
 	{
 		/* then we can finaly read the body */
-		U_ArrCpy(body, &aligned_RX_buffer[bodyPos], (*bodyLength));
+		U_ArrCpy(body, &UART_RX_alignedBuffer[bodyPos], (*bodyLength));
+		/* and the next package can begin right after this one */
+		UART_RX_alignedPos = bodyPos + (*bodyLength) + UART_STOP_SEQ_LENGTH;
 	} else 
 	{
 		/* else we assign bodyLength to zero to show what package was not found */
 		(*bodyLength) = 0u;
+		UART_IncrErrorCounter(UART_ERR_CNT_BAD_FRAME);
+		if(startSeqFound == D_TRUE)
+		{
+			/* Skip broken start sequence, there can be valid package behind it */
+			UART_RX_alignedPos = startSeqPos + 1u;
+		} else
+		{
+			/* Nothing more to look for */
+			UART_RX_alignedPos = UART_RX_alignedLength;
+		}
 	}
 }
 ISR(USART_TXC_vect) 
 {
-	if(UART_TX_writePos != UART_TX_readPos) 
-    {
-		UDR = UART_TX_buffer[UART_TX_readPos];
-
-		UART_TX_readPos++;
-		if(UART_TX_readPos >= UART_TX_BUFFER_SIZE) 
-        {
-			UART_TX_readPos = 0u;
-		}
-	}
+	UART_TX_SendNext();
 }
 ISR(USART_RXC_vect) 
 {
-	UART_RX_busyState = UART_RX_BUSY;
-	UART_RX_buffer[UART_RX_writePos] = UDR;
+	uint8_t status = 0u;
+	uint8_t data = 0u;
+	uint8_t nextWritePos = 0u;
+#ifdef UART_RS485_MODE
+	uint8_t controlStatus = 0u;
+#endif
+
+	/* Error flags are valid only until UDR is read, so take them first */
+	status = UCSRA;
+#ifdef UART_RS485_MODE
+	/* 9th bit as well */
+	controlStatus = UCSRB;
+#endif
+	data = UDR;
 
-	if(UART_RX_buffer[UART_RX_writePos] == '\n')
+	if(status & (1<<DOR))
 	{
-		UART_RX_busyState = UART_RX_FREE;
+		UART_IncrErrorCounter(UART_ERR_CNT_OVERRUN);
 	}
-
-	UART_RX_writePos++;
-	if(UART_RX_writePos >= UART_RX_BUFFER_SIZE) 
-    {
-		UART_RX_writePos = 0u;
+	if(status & (1<<FE))
+	{
+		UART_IncrErrorCounter(UART_ERR_CNT_FRAMING);
+	}
+	if(status & (1<<PE))
+	{
+		UART_IncrErrorCounter(UART_ERR_CNT_PARITY);
 	}
+
+#ifdef UART_RS485_MODE
+	/* TXC flag is cleared by writing one to it, so it is masked out
+	   when MPCM is changed, otherwise pending TXC would be lost */
+	if(controlStatus & (1<<RXB8))
+	{
+		/* Address byte: take the next frame only if it is for us */
+		if( (data == UART_nodeAddress) || (data == UART_BROADCAST_ADDRESS) )
+		{
+			UART_RX_broadcastState = (data == UART_BROADCAST_ADDRESS) ? D_TRUE : D_FALSE;
+			UCSRA = UCSRA & (uint8_t)~( (1<<MPCM) | (1<<TXC) );
+		} else
+		{
+			UCSRA = (UCSRA & (uint8_t)~(1<<TXC)) | (1<<MPCM);
+		}
+	} else
+#endif
+	{
+		if(UART_RX_busyState == UART_RX_FREE)
+		{
+			/* First byte of a new line */
+			UART_RX_frameStartStamp = TT_GetTimestamp();
+		}
+		UART_RX_busyState = UART_RX_BUSY;
+		if(data == '\n')
+		{
+			UART_RX_busyState = UART_RX_FREE;
+		}
+
+		nextWritePos = UART_RX_writePos + 1u;
+		if(nextWritePos >= UART_RX_BUFFER_SIZE) 
+		{
+			nextWritePos = 0u;
+		}
+		/* If ring is full we drop the byte instead of overwriting unread data */
+		if(nextWritePos == UART_RX_readPos)
+		{
+			UART_IncrErrorCounter(UART_ERR_CNT_RING_OVERFLOW);
+		} else
+		{
+			UART_RX_buffer[UART_RX_writePos] = data;
+			UART_RX_writePos = nextWritePos;
+			if(UART_RX_lineLength < UINT8_MAX)
+			{
+				UART_RX_lineLength++;
+			}
+			/* Stamp ring holds as many lines as RX ring can hold shortest
+			   frames, shorter lines are not stamped, so it never overflows */
+			if(data == '\n')
+			{
+				if( (UART_RX_lineLength >= UART_RX_MIN_FRAME_LENGTH) &&
+					( ((UART_RX_stampWritePos + 1u) % UART_RX_STAMP_BUFFER_SIZE) != UART_RX_stampReadPos ) )
+				{
+					UART_RX_stampBuffer[UART_RX_stampWritePos].start = UART_RX_frameStartStamp;
+					UART_RX_stampBuffer[UART_RX_stampWritePos].complete = TT_GetTimestamp();
+					UART_RX_stampBuffer[UART_RX_stampWritePos].broadcast = UART_RX_broadcastState;
+					UART_RX_stampWritePos = (UART_RX_stampWritePos + 1u) % UART_RX_STAMP_BUFFER_SIZE;
+				}
+				UART_RX_lineLength = 0u;
+			}
+		}
 	
-	UART_RX_newDataLength++;
+		UART_RX_newDataLength++;
+#ifdef UART_RS485_MODE
+		/* Frame is over, ignore the bus until we are addressed again */
+		if(data == '\n')
+		{
+			UCSRA = (UCSRA & (uint8_t)~(1<<TXC)) | (1<<MPCM);
+		}
+#endif
+	}
 }
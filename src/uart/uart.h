@@ -4,8 +4,43 @@
 #include <avr/io.h>
 #include "../stringmanager/stringmanager.h"
 
-#define UART_TX_BUFFER_SIZE 64u
-#define UART_RX_BUFFER_SIZE 32u
+/* Define UART_RS485_MODE to run the USART as an addressed node of RS-485
+   multi-drop bus: 9 data bits, the 9th bit set marks an address byte.
+   Receiver stays in multi-processor mode (MPCM) and hardware ignores
+   every data byte until the node or broadcast address is received, then
+   one frame up to '\n' is taken and MPCM is set again. Transmitter is
+   enabled by RS485_DE pin, which is released in TXC interrupt after
+   the stop bit of the last byte has left the line. RS485_DE is PC3, the
+   ticker leaves out its RED_LED_2 on that pin in this mode.
+   Only the addressed node may drive the bus, so frames nobody asked for
+   (telemetry, job events, script log) are not sent on it in this mode */
+//#define UART_RS485_MODE
+
+/* Node address is kept in EEPROM, erased cell means default one */
+#define UART_NODE_ADDRESS_DEFAULT 0x01u
+#define UART_NODE_ADDRESS_ERASED 0xFFu
+/* Frames sent to this address are taken by every node, but not answered */
+#define UART_BROADCAST_ADDRESS 0x00u
+
+/* Virtual channels share the link frame by frame. Every channel has its
+   own TX queue, the channel id is the priority as well (0 is the highest),
+   so command responses never wait for more than one frame of bulk data.
+   Channel id is sent as one hex digit right after the start sequence */
+/* Define UART_SOFT_CHANNELS to send telemetry and log frames on the
+   software UART (see softuart.h, needs SUART_ENABLED) instead, the USART
+   then carries only the command channel. On RS-485 bus they are sent
+   there as well */
+//#define UART_SOFT_CHANNELS
+#define UART_CH_CMD 0u
+#define UART_CH_TLM 1u
+#define UART_CH_LOG 2u
+#define UART_CH_QUANTITY 3u
+
+#define UART_TX_CMD_BUFFER_SIZE 64u
+#define UART_TX_TLM_BUFFER_SIZE 48u
+#define UART_TX_LOG_BUFFER_SIZE 32u
+/* Holds one frame with a full size body, e.g. a bat command */
+#define UART_RX_BUFFER_SIZE 64u
 
 #define UART_RX_BUSY 0
 #define UART_RX_FREE 1
@@ -13,15 +48,63 @@
 #define UART_START_SEQ_LENGTH 3u
 #define UART_STOP_SEQ_LENGTH 4u
 #define UART_LENGTH_OF_BODY_LENGTH STR_8BIT_STRING_LENGTH
+#define UART_CHANNEL_ID_LENGTH 1u
+/* Frame length stored in TX queue in front of every frame */
+#define UART_FRAME_PREFIX_LENGTH 1u
+#define UART_FRAME_HEADER_LENGTH (UART_START_SEQ_LENGTH + UART_CHANNEL_ID_LENGTH + UART_LENGTH_OF_BODY_LENGTH)
+/* Prefix with this bit set is followed by the address of a complete
+   frame in flash instead of the frame itself */
+#define UART_FRAME_PREFIX_FLASH 0x80u
+#define UART_FLASH_FRAME_REF_LENGTH sizeof(const uint8_t *)
+
+/* Complete CMD channel frame as a string literal, for frames prepared
+   at compile time. Body length is given as 2 hex digits, e.g. 09 */
+#define UART_CMD_FLASH_FRAME(bodyLengthHex, body) "ASK0" #bodyLengthHex body "END\n"
+
+/* One cell of TX ring always stays empty, so the whole package with its
+   length prefix must fit in one cell less */
+#define UART_CH_MAX_BODY_LENGTH(bufferSize) ( ((bufferSize) - 1u) - (UART_FRAME_PREFIX_LENGTH + UART_START_SEQ_LENGTH + UART_CHANNEL_ID_LENGTH + UART_LENGTH_OF_BODY_LENGTH + UART_STOP_SEQ_LENGTH) )
+#define UART_MAX_BODY_LENGTH UART_CH_MAX_BODY_LENGTH(UART_TX_CMD_BUFFER_SIZE)
 
-#define UART_MAX_BODY_LENGTH UART_TX_BUFFER_SIZE - (UART_START_SEQ_LENGTH + UART_STOP_SEQ_LENGTH + UART_LENGTH_OF_BODY_LENGTH)
+/* Line error counters, saturate at UART_ERR_CNT_MAX */
+#define UART_ERR_CNT_OVERRUN 0u
+#define UART_ERR_CNT_FRAMING 1u
+#define UART_ERR_CNT_PARITY 2u
+#define UART_ERR_CNT_RING_OVERFLOW 3u
+#define UART_ERR_CNT_BAD_FRAME 4u
+#define UART_ERR_CNT_QUANTITY 5u
+
+#define UART_ERR_CNT_MAX 0xFFu
+
+/* Shortest received frame: start sequence, body length, empty body, stop */
+#define UART_RX_MIN_FRAME_LENGTH (UART_START_SEQ_LENGTH + UART_LENGTH_OF_BODY_LENGTH + UART_STOP_SEQ_LENGTH)
+/* Receive timestamps are kept for every line that may be a frame, RX ring
+   holds at most this many of them and one cell of stamp ring stays empty */
+#define UART_RX_STAMP_BUFFER_SIZE ((UART_RX_BUFFER_SIZE / UART_RX_MIN_FRAME_LENGTH) + 1u)
 
 extern void UART_Init(void);
-extern void UART_TX_WriteStr(const uint8_t chArr[], const uint8_t length);
 extern void UART_RX_ReadArray(uint8_t *dst, const uint8_t length);
 
 extern void UART_TX_WritePackage(const uint8_t body[], const uint8_t bodyLength);
+extern uint8_t UART_TX_WriteChannelPackage(const uint8_t channel, const uint8_t body[], const uint8_t bodyLength);
+/* For frames nobody asked for, they are dropped on RS-485 bus */
+extern uint8_t UART_TX_WriteUnsolicitedPackage(const uint8_t channel, const uint8_t body[], const uint8_t bodyLength);
+extern uint8_t UART_TX_IsUnsolicitedAllowed(const uint8_t channel);
+extern uint8_t UART_TX_WriteFlashFrame(const uint8_t channel, const uint8_t *frame, const uint8_t frameLength);
+/* Tells if a package with bodyLength long body fits the channel queue now */
+extern uint8_t UART_TX_IsRoomForPackage(const uint8_t channel, const uint8_t bodyLength);
+/* Moves complete lines from RX ring for parsing, returns their length */
+extern uint8_t UART_RX_FetchBuffer(void);
 extern void UART_RX_ReadPackage(uint8_t body[], uint8_t *bodyLength, uint8_t *error);
+extern uint8_t UART_RX_IsPackagePending(void);
+extern void UART_RX_Get_PackageTimestamps(uint16_t *rxStart, uint16_t *rxComplete);
 
 uint16_t UART_Get_RX_newDataLength(void);
+
+extern uint8_t UART_Get_NodeAddress(void);
+extern void UART_Set_NodeAddress(const uint8_t address, uint8_t *error);
+extern uint8_t UART_RX_IsBroadcast(void);
+
+extern uint8_t UART_Get_ErrorCounter(const uint8_t counterId);
+extern void UART_ReportErrorCounters(void);
 #endif
\ No newline at end of file
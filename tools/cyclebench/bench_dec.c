@@ -0,0 +1,126 @@
+/* Cycles of the decimal conversion: STR_NumberToString and
+   STR_16BitNumberToString against the previous double dabble conversion,
+   which is kept here as a reference. Results are checked against ultoa
+   over the whole 32-bit range. */
+#include <stdlib.h>
+#include <string.h>
+
+#include "cyclebench.h"
+#include "stringmanager/stringmanager.h"
+
+#define BENCH_DEC_BCD_DIGIT_MASK (uint32_t)15u
+#define BENCH_DEC_BCD_DIGIT_STEP 4u
+#define BENCH_DEC_BCD_DIGIT_QUANTITY 5u
+#define BENCH_DEC_BCD_MAX_NUMBER 99999ul
+/* Random inputs of the check, besides all 16-bit values */
+#define BENCH_DEC_RANDOM_CHECKS 20000ul
+
+static const uint32_t BenchDecInputs[] = {
+    0ul, 7ul, 42ul, 1023ul, 2560ul, 9999ul, 65535ul, 99999ul,
+    100000ul, 1234567ul, 99999999ul, 1000000000ul, 4294967295ul
+};
+
+/* Previous STR_NumberToString: 5 digits, bigger numbers wrap */
+static void __attribute__((noinline)) BENCH_DEC_BcdNumberToString(char *str, const uint32_t number)
+{
+    int8_t idx = 0;
+    uint8_t digitIdx = 0u;
+    uint32_t BCDvalue = 0u;
+    uint32_t newNumber = number;
+
+    if(number > BENCH_DEC_BCD_MAX_NUMBER)
+    {
+        newNumber = newNumber - (BENCH_DEC_BCD_MAX_NUMBER + 1);
+    }
+    BCDvalue = STR_16bitDecToBCD(newNumber);
+    for(idx = BENCH_DEC_BCD_DIGIT_QUANTITY - 1; idx >= 0; idx--)
+    {
+        str[idx] = ( (uint32_t)( BCDvalue & (BENCH_DEC_BCD_DIGIT_MASK << digitIdx ) ) >> digitIdx ) + '0';
+        digitIdx += BENCH_DEC_BCD_DIGIT_STEP;
+    }
+}
+
+static uint8_t BENCH_DEC_Matches(const uint32_t number)
+{
+    char str[STR_32BIT_DEC_STRING_LENGTH];
+    char str16[STR_16BIT_DEC_STRING_LENGTH];
+    char reference[STR_32BIT_DEC_STRING_LENGTH + 1u];
+    uint8_t zeros = 0u;
+    uint8_t idx = 0u;
+    uint8_t retVal = 0u;
+
+    STR_NumberToString(str, number);
+    ultoa(number, reference, 10);
+    /* Leading digits are zeros, the rest is the reference */
+    zeros = STR_32BIT_DEC_STRING_LENGTH - (uint8_t)strlen(reference);
+    retVal = (memcmp(&str[zeros], reference, STR_32BIT_DEC_STRING_LENGTH - zeros) == 0);
+    for(idx = 0u; idx < zeros; idx++)
+    {
+        retVal = retVal && (str[idx] == '0');
+    }
+    if(number <= UINT16_MAX)
+    {
+        STR_16BitNumberToString(str16, (uint16_t)number);
+        retVal = retVal && (memcmp(str16, &str[STR_32BIT_DEC_STRING_LENGTH - STR_16BIT_DEC_STRING_LENGTH], STR_16BIT_DEC_STRING_LENGTH) == 0);
+    }
+    return retVal;
+}
+
+static void BENCH_DEC_Check(void)
+{
+    uint32_t number = 0u;
+    uint32_t errors = 0u;
+    uint32_t checked = 0u;
+    uint32_t idx = 0u;
+
+    /* Every 16-bit value */
+    for(number = 0u; number <= UINT16_MAX; number++)
+    {
+        errors += (BENCH_DEC_Matches(number) == 0u);
+        checked++;
+    }
+    /* Around every power of ten and the top of the range */
+    for(number = 1u; number <= 1000000000ul; number *= 10u)
+    {
+        errors += (BENCH_DEC_Matches(number - 1u) == 0u);
+        errors += (BENCH_DEC_Matches(number) == 0u);
+        checked += 2u;
+    }
+    errors += (BENCH_DEC_Matches(UINT32_MAX) == 0u);
+    checked++;
+    /* Random 32-bit values, fixed seed so runs are comparable */
+    srandom(1u);
+    for(idx = 0u; idx < BENCH_DEC_RANDOM_CHECKS; idx++)
+    {
+        errors += (BENCH_DEC_Matches((uint32_t)random() ^ ((uint32_t)random() << 16)) == 0u);
+        checked++;
+    }
+    CB_ReportCheck("STR_NumberToString", checked, errors);
+}
+
+int main(void)
+{
+    char str[STR_32BIT_DEC_STRING_LENGTH];
+    uint16_t cycles = 0u;
+    uint8_t idx = 0u;
+    uint32_t number = 0u;
+
+    CB_Init();
+    CB_Header();
+    for(idx = 0u; idx < (sizeof(BenchDecInputs) / sizeof(BenchDecInputs[0])); idx++)
+    {
+        number = BenchDecInputs[idx];
+        CB_MEASURE(cycles, BENCH_DEC_BcdNumberToString(str, number));
+        CB_Report("BENCH_DEC_BcdNumberToString", number, cycles);
+        CB_MEASURE(cycles, STR_NumberToString(str, number));
+        CB_Report("STR_NumberToString", number, cycles);
+        if(number <= UINT16_MAX)
+        {
+            CB_MEASURE(cycles, STR_16BitNumberToString(str, (uint16_t)number));
+            CB_Report("STR_16BitNumberToString", number, cycles);
+        }
+    }
+    BENCH_DEC_Check();
+    CB_Done();
+    return 0;
+}
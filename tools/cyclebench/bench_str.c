@@ -0,0 +1,130 @@
+/* Cycles of the stringmanager conversions and field writers, decimal
+   conversion itself is in bench_dec.c */
+#include <stdio.h>
+#include <avr/pgmspace.h>
+
+#include "cyclebench.h"
+#include "stringmanager/stringmanager.h"
+
+#define BENCH_STR_FIELD_LENGTH 5u
+#define BENCH_STR_HEX_MAX_LENGTH 22u
+/* One LCD line and the terminating zero */
+#define BENCH_STR_LINE_CAPACITY 17u
+
+typedef struct
+{
+    const char *name;
+    uint8_t alignment;
+    uint8_t filling;
+} ts_BENCH_STR_Format;
+
+static const uint32_t BenchStrBcdInputs[] = {0ul, 1023ul, 65535ul, 99999ul};
+static const uint32_t BenchStrFieldInputs[] = {7ul, 1023ul, 99999ul};
+static const ts_BENCH_STR_Format BenchStrFormats[] = {
+    {"STR_WriteNumberToArray/right_none", STR_ALIGNMENT_RIGHT, STR_FILLING_NONE},
+    {"STR_WriteNumberToArray/right_spaces", STR_ALIGNMENT_RIGHT, STR_FILLING_SPACES},
+    {"STR_WriteNumberToArray/right_zeros", STR_ALIGNMENT_RIGHT, STR_FILLING_ZEROS},
+    {"STR_WriteNumberToArray/left_spaces", STR_ALIGNMENT_LEFT, STR_FILLING_SPACES}
+};
+static const int32_t BenchStrFixedInputs[] = {-5l, 2560l, 99999l};
+static const uint8_t BenchStrHexLengths[] = {1u, 2u, BENCH_STR_HEX_MAX_LENGTH};
+static const uint8_t BenchStrHexDigits[] = {1u, 2u, 4u, 8u};
+
+static char BenchStrField[BENCH_STR_FIELD_LENGTH];
+static char BenchStrFixed[STR_FIXED_STRING_LENGTH];
+static uint8_t BenchStrHexText[BENCH_STR_HEX_MAX_LENGTH * STR_8BIT_STRING_LENGTH];
+static uint8_t BenchStrHexBytes[BENCH_STR_HEX_MAX_LENGTH];
+static char BenchStrLine[BENCH_STR_LINE_CAPACITY];
+
+static void BENCH_STR_Decimal(void)
+{
+    uint8_t idx = 0u;
+    uint8_t formatIdx = 0u;
+    uint16_t cycles = 0u;
+    volatile uint32_t result = 0u;
+
+    for(idx = 0u; idx < (sizeof(BenchStrBcdInputs) / sizeof(BenchStrBcdInputs[0])); idx++)
+    {
+        CB_MEASURE(cycles, result = STR_16bitDecToBCD(BenchStrBcdInputs[idx]));
+        CB_Report("STR_16bitDecToBCD", BenchStrBcdInputs[idx], cycles);
+    }
+    for(formatIdx = 0u; formatIdx < (sizeof(BenchStrFormats) / sizeof(BenchStrFormats[0])); formatIdx++)
+    {
+        for(idx = 0u; idx < (sizeof(BenchStrFieldInputs) / sizeof(BenchStrFieldInputs[0])); idx++)
+        {
+            CB_MEASURE(cycles, STR_WriteNumberToArray(BenchStrField, 0u, BENCH_STR_FIELD_LENGTH,
+                BenchStrFormats[formatIdx].alignment, BenchStrFormats[formatIdx].filling, BenchStrFieldInputs[idx]));
+            CB_Report(BenchStrFormats[formatIdx].name, BenchStrFieldInputs[idx], cycles);
+        }
+    }
+    /* Input is the absolute value, the negative one is in mV */
+    for(idx = 0u; idx < (sizeof(BenchStrFixedInputs) / sizeof(BenchStrFixedInputs[0])); idx++)
+    {
+        CB_MEASURE(cycles, result = STR_FixedToString(BenchStrFixed, BenchStrFixedInputs[idx], 3u, "V"));
+        CB_Report("STR_FixedToString/3_decimals", (BenchStrFixedInputs[idx] < 0) ? -BenchStrFixedInputs[idx] : BenchStrFixedInputs[idx], cycles);
+    }
+    (void)result;
+}
+
+static void BENCH_STR_Hex(void)
+{
+    uint8_t idx = 0u;
+    uint8_t error = 0u;
+    uint16_t cycles = 0u;
+    volatile uint32_t result = 0u;
+
+    for(idx = 0u; idx < sizeof(BenchStrHexText); idx++)
+    {
+        BenchStrHexText[idx] = (idx & 1u) ? 'a' : '5';
+    }
+    /* Input is the number of bytes */
+    for(idx = 0u; idx < sizeof(BenchStrHexLengths); idx++)
+    {
+        CB_MEASURE(cycles, STR_HexDecode(BenchStrHexBytes, BenchStrHexText, BenchStrHexLengths[idx], &error));
+        CB_Report("STR_HexDecode", BenchStrHexLengths[idx], cycles);
+        CB_MEASURE(cycles, STR_HexEncode(BenchStrHexText, BenchStrHexBytes, BenchStrHexLengths[idx]));
+        CB_Report("STR_HexEncode", BenchStrHexLengths[idx], cycles);
+    }
+    /* Input is the number of digits */
+    for(idx = 0u; idx < sizeof(BenchStrHexDigits); idx++)
+    {
+        CB_MEASURE(cycles, result = STR_StringToHex(BenchStrHexText, BenchStrHexDigits[idx], &error));
+        CB_Report("STR_StringToHex", BenchStrHexDigits[idx], cycles);
+    }
+    CB_MEASURE(cycles, result = STR_StringTo8BitHex(BenchStrHexText, &error));
+    CB_Report("STR_StringTo8BitHex", STR_8BIT_STRING_LENGTH, cycles);
+    CB_MEASURE(cycles, STR_8BitHexToString(BenchStrHexText, 0xA5u));
+    CB_Report("STR_8BitHexToString", STR_8BIT_STRING_LENGTH, cycles);
+    if(error != 0u)
+    {
+        CB_PrintString("hex input rejected\n");
+    }
+    (void)result;
+}
+
+/* Status line in one call, avr-libc snprintf_P is the reference. Its
+   code is in vfprintf, so the size column shows only the wrapper */
+static void BENCH_STR_Format(void)
+{
+    uint16_t cycles = 0u;
+    volatile uint8_t result = 0u;
+
+    /* Input is the number of characters written */
+    CB_MEASURE(cycles, result = STR_Format(BenchStrLine, sizeof(BenchStrLine), PSTR("T=%3u.%1uC E:%02X"), 25u, 3u, 0x1Fu));
+    CB_Report("STR_Format/status_line", result, cycles);
+    CB_MEASURE(cycles, result = snprintf_P(BenchStrLine, sizeof(BenchStrLine), PSTR("T=%3u.%1uC E:%02X"), 25u, 3u, 0x1Fu));
+    CB_Report("snprintf_P/status_line", result, cycles);
+    CB_MEASURE(cycles, result = STR_Format(BenchStrLine, sizeof(BenchStrLine), PSTR("%6.3ldV %-4s"), 2560l, "ok"));
+    CB_Report("STR_Format/fixed_string", result, cycles);
+}
+
+int main(void)
+{
+    CB_Init();
+    CB_Header();
+    BENCH_STR_Decimal();
+    BENCH_STR_Hex();
+    BENCH_STR_Format();
+    CB_Done();
+    return 0;
+}
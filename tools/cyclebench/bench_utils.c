@@ -0,0 +1,95 @@
+/* Cycles of the bit and array helpers of src/utils */
+#include <string.h>
+
+#include "cyclebench.h"
+#include "utils/utils.h"
+
+/* Command name, LCD line and frame body lengths */
+#define BENCH_UTILS_ARRAY_LENGTH_QUANTITY 3u
+#define BENCH_UTILS_ARRAY_MAX_LENGTH 52u
+#define BENCH_UTILS_STATE_1 0x11u
+#define BENCH_UTILS_STATE_2 0x22u
+#define BENCH_UTILS_STATE_OTHER 0x33u
+
+typedef struct
+{
+    uint8_t position;
+    uint8_t mask;
+} ts_BENCH_UTILS_BitSeq;
+
+static const uint8_t BenchUtilsLengths[BENCH_UTILS_ARRAY_LENGTH_QUANTITY] = {3u, 16u, BENCH_UTILS_ARRAY_MAX_LENGTH};
+static const char * const BenchUtilsArrCmpNames[BENCH_UTILS_ARRAY_LENGTH_QUANTITY] = {"U_ArrCmp/3", "U_ArrCmp/16", "U_ArrCmp/52"};
+static const char * const BenchUtilsArrCpyNames[BENCH_UTILS_ARRAY_LENGTH_QUANTITY] = {"U_ArrCpy/3", "U_ArrCpy/16", "U_ArrCpy/52"};
+static const ts_BENCH_UTILS_BitSeq BenchUtilsBitSeqs[] = {
+    {0u, 0x0Fu}, {4u, 0xF0u}, {6u, 0xC0u}, {7u, 0x80u}
+};
+static const uint8_t BenchUtilsPositions[] = {0u, 3u, 7u};
+
+static uint8_t BenchUtilsArrA[BENCH_UTILS_ARRAY_MAX_LENGTH];
+static uint8_t BenchUtilsArrB[BENCH_UTILS_ARRAY_MAX_LENGTH];
+
+static void BENCH_UTILS_Bits(void)
+{
+    uint8_t cell = 0u;
+    uint8_t position = 0u;
+    uint8_t idx = 0u;
+    uint16_t cycles = 0u;
+    volatile uint8_t result = 0u;
+
+    /* Input is the bit position */
+    for(idx = 0u; idx < sizeof(BenchUtilsPositions); idx++)
+    {
+        position = BenchUtilsPositions[idx];
+        CB_MEASURE(cycles, U_BitToConfig(&cell, position, BENCH_UTILS_STATE_1, BENCH_UTILS_STATE_2, BENCH_UTILS_STATE_1));
+        CB_Report("U_BitToConfig/state1", position, cycles);
+        CB_MEASURE(cycles, U_BitToConfig(&cell, position, BENCH_UTILS_STATE_1, BENCH_UTILS_STATE_2, BENCH_UTILS_STATE_2));
+        CB_Report("U_BitToConfig/state2", position, cycles);
+        CB_MEASURE(cycles, U_BitToConfig(&cell, position, BENCH_UTILS_STATE_1, BENCH_UTILS_STATE_2, BENCH_UTILS_STATE_OTHER));
+        CB_Report("U_BitToConfig/other", position, cycles);
+        CB_MEASURE(cycles, result = U_BitFromConfig(&cell, position, BENCH_UTILS_STATE_1, BENCH_UTILS_STATE_2));
+        CB_Report("U_BitFromConfig", position, cycles);
+    }
+    for(idx = 0u; idx < (sizeof(BenchUtilsBitSeqs) / sizeof(BenchUtilsBitSeqs[0])); idx++)
+    {
+        CB_MEASURE(cycles, U_BitSeqToConfig(&cell, BenchUtilsBitSeqs[idx].position, BenchUtilsBitSeqs[idx].mask, 1u));
+        CB_Report("U_BitSeqToConfig", BenchUtilsBitSeqs[idx].position, cycles);
+        CB_MEASURE(cycles, result = U_BitSeqFromConfig(&cell, BenchUtilsBitSeqs[idx].position, BenchUtilsBitSeqs[idx].mask));
+        CB_Report("U_BitSeqFromConfig", BenchUtilsBitSeqs[idx].position, cycles);
+    }
+    (void)result;
+}
+
+static void BENCH_UTILS_Arrays(void)
+{
+    uint8_t length = 0u;
+    uint8_t idx = 0u;
+    uint16_t cycles = 0u;
+    volatile int8_t result = 0;
+
+    for(idx = 0u; idx < BENCH_UTILS_ARRAY_LENGTH_QUANTITY; idx++)
+    {
+        length = BenchUtilsLengths[idx];
+        memset(BenchUtilsArrA, 'a', sizeof(BenchUtilsArrA));
+        memset(BenchUtilsArrB, 'a', sizeof(BenchUtilsArrB));
+        /* Input is the index of the first difference, length if equal */
+        CB_MEASURE(cycles, result = U_ArrCmp(BenchUtilsArrA, BenchUtilsArrB, length));
+        CB_Report(BenchUtilsArrCmpNames[idx], length, cycles);
+        BenchUtilsArrB[0] = 'b';
+        CB_MEASURE(cycles, result = U_ArrCmp(BenchUtilsArrA, BenchUtilsArrB, length));
+        CB_Report(BenchUtilsArrCmpNames[idx], 0u, cycles);
+        /* Input is the length */
+        CB_MEASURE(cycles, U_ArrCpy(BenchUtilsArrA, BenchUtilsArrB, length));
+        CB_Report(BenchUtilsArrCpyNames[idx], length, cycles);
+    }
+    (void)result;
+}
+
+int main(void)
+{
+    CB_Init();
+    CB_Header();
+    BENCH_UTILS_Bits();
+    BENCH_UTILS_Arrays();
+    CB_Done();
+    return 0;
+}
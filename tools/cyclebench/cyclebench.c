@@ -0,0 +1,124 @@
+#include "cyclebench.h"
+
+#include <stdlib.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+/* 250000 baud at 16 MHz, same as the firmware */
+#define CB_UBRR 3u
+#define CB_NUMBER_STRING_LENGTH 11u
+#define CB_NAME_COLUMN 32u
+#define CB_INPUT_COLUMN 12u
+
+static uint16_t CB_overhead = 0u;
+
+static void CB_PrintChar(const char ch)
+{
+    while( (UCSRA & (1 << UDRE)) == 0u )
+    {
+        /* Wait for the previous byte */
+    }
+    UDR = (uint8_t)ch;
+}
+
+static void CB_PrintColumn(const char *str, const uint8_t width)
+{
+    uint8_t length = 0u;
+
+    for(length = 0u; str[length] != '\0'; length++)
+    {
+        CB_PrintChar(str[length]);
+    }
+    for(; length < width; length++)
+    {
+        CB_PrintChar(' ');
+    }
+}
+
+void CB_PrintString(const char *str)
+{
+    CB_PrintColumn(str, 0u);
+}
+
+void CB_PrintNumber(const uint32_t number)
+{
+    char str[CB_NUMBER_STRING_LENGTH];
+
+    /* Not measured, so the library conversion is good enough */
+    ultoa(number, str, 10);
+    CB_PrintString(str);
+}
+
+void CB_Init(void)
+{
+    uint16_t cycles = 0u;
+
+    UBRRH = 0u;
+    UBRRL = CB_UBRR;
+    UCSRB = (1 << TXEN);
+    UCSRC = (1 << URSEL) | (1 << UCSZ1) | (1 << UCSZ0);
+
+    /* Timer1 in normal mode without prescaler */
+    TCCR1A = 0u;
+    TCCR1B = (1 << CS10);
+
+    /* Cost of an empty measurement, removed from every result */
+    CB_MEASURE(cycles, (void)0);
+    CB_overhead = cycles;
+}
+
+uint16_t CB_Cycles(const uint16_t counted)
+{
+    uint16_t retVal = CB_OVERFLOW;
+
+    if( (TIFR & (1 << TOV1)) == 0u )
+    {
+        retVal = counted - CB_overhead;
+    }
+    return retVal;
+}
+
+void CB_Header(void)
+{
+    CB_PrintColumn("case", CB_NAME_COLUMN);
+    CB_PrintColumn("input", CB_INPUT_COLUMN);
+    CB_PrintString("cycles\n");
+}
+
+void CB_Report(const char *name, const uint32_t input, const uint16_t cycles)
+{
+    char str[CB_NUMBER_STRING_LENGTH];
+
+    CB_PrintColumn(name, CB_NAME_COLUMN);
+    ultoa(input, str, 10);
+    CB_PrintColumn(str, CB_INPUT_COLUMN);
+    CB_PrintNumber(cycles);
+    CB_PrintChar('\n');
+}
+
+void CB_ReportCheck(const char *name, const uint32_t checked, const uint32_t errors)
+{
+    CB_PrintString("check ");
+    CB_PrintString(name);
+    CB_PrintChar(' ');
+    CB_PrintNumber(checked);
+    CB_PrintString(" values, ");
+    CB_PrintNumber(errors);
+    CB_PrintString(" errors\n");
+}
+
+void CB_Done(void)
+{
+    CB_PrintString("done\n");
+    /* Let the last byte leave the shift register */
+    UCSRA = (1 << TXC);
+    while( (UCSRA & (1 << TXC)) == 0u )
+    {
+        /* Wait for the end of transmission */
+    }
+    /* Sleeping with interrupts disabled ends the simavr run */
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    sleep_enable();
+    cli();
+    sleep_cpu();
+}
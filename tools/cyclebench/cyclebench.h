@@ -0,0 +1,37 @@
+/* Cycle counting helpers of the benchmark programs. Timer1 runs at the
+   CPU clock, so reading TCNT1 after a call gives its cost in cycles, the
+   same on simavr and on the real board. Results are printed over USART
+   as lines of
+
+       <case> <input> <cycles>
+
+   Case names have no spaces, the part before '/' is the measured
+   function, so cyclereport.py can add its code size. Calls longer than
+   one Timer1 period (65535 cycles) are reported as CB_OVERFLOW. */
+#ifndef cyclebench_h
+#define cyclebench_h
+
+#include <avr/io.h>
+
+#define CB_OVERFLOW 0xFFFFu
+
+/* Measures statement call, the TCNT1 write and read overhead is removed */
+#define CB_MEASURE(cycles, call)                    \
+    do {                                            \
+        TIFR = (1 << TOV1);                         \
+        TCNT1 = 0u;                                 \
+        call;                                       \
+        (cycles) = TCNT1;                           \
+        (cycles) = CB_Cycles(cycles);               \
+    } while(0)
+
+extern void CB_Init(void);
+extern uint16_t CB_Cycles(const uint16_t counted);
+extern void CB_PrintString(const char *str);
+extern void CB_PrintNumber(const uint32_t number);
+extern void CB_Header(void);
+extern void CB_Report(const char *name, const uint32_t input, const uint16_t cycles);
+extern void CB_ReportCheck(const char *name, const uint32_t checked, const uint32_t errors);
+extern void CB_Done(void);
+
+#endif
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""
+Runs the benchmark ELF files in simavr (cyclerun), adds the code size of
+every measured function (avr-nm) and prints one table. Results can be
+saved as baseline and later runs compared with it: cycles are exact, so
+any growth of a case is reported as regression.
+
+Example:
+    cyclereport.py bench_utils.elf bench_str.elf --save baseline.json
+    cyclereport.py bench_*.elf --baseline baseline.json
+"""
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+CHECK_TAG = "check"
+FUNCTION_SEPARATOR = "/"
+# Symbol types of code in nm output
+CODE_SYMBOLS = "tTwW"
+
+
+def run_bench(runner, elf):
+    """Returns ({"case input": cycles}, [failed checks])."""
+    output = subprocess.run([runner, elf], check=True, capture_output=True, text=True).stdout
+    cycles = {}
+    failed = []
+    for line in output.splitlines():
+        fields = line.split()
+        if fields and fields[0] == CHECK_TAG:
+            # check <name> <n> values, <errors> errors
+            if int(fields[4]) != 0:
+                failed.append(line)
+        elif len(fields) == 3 and fields[1].isdigit() and fields[2].isdigit():
+            cycles["%s %s" % (fields[0], fields[1])] = int(fields[2])
+    return cycles, failed
+
+
+def code_sizes(nm, elf):
+    """Returns {function: bytes} of the ELF."""
+    sizes = {}
+    output = subprocess.run([nm, "-S", elf], check=True, capture_output=True, text=True).stdout
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) == 4 and fields[2] in CODE_SYMBOLS:
+            sizes[fields[3]] = int(fields[1], 16)
+    return sizes
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("elf", nargs="+", help="benchmark ELF files")
+    ap.add_argument("--runner", default="./cyclerun", help="simavr runner")
+    ap.add_argument("--nm", default="avr-nm", help="nm of the AVR toolchain")
+    ap.add_argument("--save", help="write results to this file")
+    ap.add_argument("--baseline", help="compare with results saved before")
+    args = ap.parse_args()
+    if args.baseline and not os.path.isfile(args.baseline):
+        sys.exit("%s not found, create it with --save (make baseline) first" % args.baseline)
+
+    result = {"cycles": {}, "sizes": {}}
+    failed = []
+    for elf in args.elf:
+        cycles, bench_failed = run_bench(args.runner, elf)
+        sizes = code_sizes(args.nm, elf)
+        failed += ["%s: %s" % (os.path.basename(elf), line) for line in bench_failed]
+        result["cycles"].update(cycles)
+        for case in cycles:
+            function = case.split()[0].split(FUNCTION_SEPARATOR)[0]
+            if function in sizes:
+                result["sizes"][function] = sizes[function]
+
+    baseline = {"cycles": {}, "sizes": {}}
+    if args.baseline:
+        with open(args.baseline) as src:
+            baseline = json.load(src)
+
+    regressions = []
+    print("%-40s %10s %7s %6s %8s %6s" % ("case", "input", "cycles", "bytes", "base", "delta"))
+    for case, cycles in result["cycles"].items():
+        name, value = case.split()
+        function = name.split(FUNCTION_SEPARATOR)[0]
+        size = result["sizes"].get(function)
+        base = baseline["cycles"].get(case)
+        delta = "" if base is None else "%+d" % (cycles - base)
+        if base is not None and cycles > base:
+            regressions.append("%s: %d -> %d cycles" % (case, base, cycles))
+        print("%-40s %10s %7d %6s %8s %6s" % (name, value, cycles, "" if size is None else size,
+                                             "" if base is None else base, delta))
+    for function, size in result["sizes"].items():
+        base = baseline["sizes"].get(function)
+        if base is not None and size > base:
+            regressions.append("%s: %d -> %d bytes" % (function, base, size))
+
+    if args.save:
+        with open(args.save, "w") as out:
+            json.dump(result, out, indent=2, sort_keys=True)
+    for line in failed + regressions:
+        print(line, file=sys.stderr)
+    if failed or regressions:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
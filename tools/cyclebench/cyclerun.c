@@ -0,0 +1,111 @@
+/*
+ * cyclerun - runs a benchmark ELF inside simavr and copies its USART0
+ * output to stdout. The benchmark measures cycles itself with Timer1
+ * (see cyclebench.h), simavr only has to run it as fast as it can.
+ *
+ * Usage: cyclerun [-m mcu] [-f freq] [-c cycles] bench.elf
+ *      -m  MCU name, atmega32 by default
+ *      -f  CPU frequency in Hz, 16000000 by default
+ *      -c  cycle limit, the run fails when it is reached
+ *
+ * The benchmark ends by sleeping with interrupts disabled, simavr
+ * reports it as done and cyclerun exits with 0.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_irq.h"
+#include "avr_uart.h"
+
+#define CYCLERUN_DEFAULT_MCU "atmega32"
+#define CYCLERUN_DEFAULT_FREQ 16000000UL
+#define CYCLERUN_DEFAULT_LIMIT 4000000000ull
+
+/* Byte transmitted by the benchmark - print it */
+static void CYCLERUN_OutputHook(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+    (void)irq;
+    (void)param;
+    putchar((int)(uint8_t)value);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *mcuName = CYCLERUN_DEFAULT_MCU;
+    unsigned long frequency = CYCLERUN_DEFAULT_FREQ;
+    avr_cycle_count_t limit = CYCLERUN_DEFAULT_LIMIT;
+    elf_firmware_t firmware;
+    avr_t *avr = NULL;
+    uint32_t uartFlags = 0u;
+    int state = cpu_Running;
+    int opt = 0;
+
+    while( (opt = getopt(argc, argv, "m:f:c:")) != -1 )
+    {
+        switch(opt)
+        {
+        case 'm':
+            mcuName = optarg;
+            break;
+        case 'f':
+            frequency = strtoul(optarg, NULL, 0);
+            break;
+        case 'c':
+            limit = strtoull(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-m mcu] [-f freq] [-c cycles] bench.elf\n", argv[0]);
+            return 1;
+        }
+    }
+    if(optind >= argc)
+    {
+        fprintf(stderr, "usage: %s [-m mcu] [-f freq] [-c cycles] bench.elf\n", argv[0]);
+        return 1;
+    }
+
+    memset(&firmware, 0, sizeof(firmware));
+    if(elf_read_firmware(argv[optind], &firmware) != 0)
+    {
+        fprintf(stderr, "cyclerun: can not read %s\n", argv[optind]);
+        return 1;
+    }
+    avr = avr_make_mcu_by_name(mcuName);
+    if(avr == NULL)
+    {
+        fprintf(stderr, "cyclerun: unknown MCU %s\n", mcuName);
+        return 1;
+    }
+    avr_init(avr);
+    avr_load_firmware(avr, &firmware);
+    avr->frequency = frequency;
+
+    /* Output goes through the hook only, not simavr's line buffered log */
+    avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &uartFlags);
+    uartFlags &= ~AVR_UART_FLAG_STDIO;
+    avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &uartFlags);
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT), CYCLERUN_OutputHook, NULL);
+
+    while( (state != cpu_Done) && (state != cpu_Crashed) && (avr->cycle < limit) )
+    {
+        state = avr_run(avr);
+    }
+    fflush(stdout);
+
+    if(state == cpu_Crashed)
+    {
+        fprintf(stderr, "cyclerun: benchmark crashed at PC 0x%04x\n", avr->pc);
+        return 2;
+    }
+    if(state != cpu_Done)
+    {
+        fprintf(stderr, "cyclerun: cycle limit reached\n");
+        return 3;
+    }
+    return 0;
+}
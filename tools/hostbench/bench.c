@@ -0,0 +1,267 @@
+/*
+ * Throughput of the frame parser and command dispatcher on the host.
+ *
+ * Every workload is a stream of input frames cut into batches that fit
+ * the USART RX ring, one batch per scheduler slot like on the board.
+ * Two stages are timed for each workload:
+ *   parse    - RX interrupt, UART_RX_FetchBuffer and UART_RX_ReadPackage
+ *   dispatch - RX interrupt and the whole scheduler slot with command
+ *              execution and transmission of responses
+ * and frames per second are printed. Compare numbers of two builds on
+ * the same machine, absolute numbers say nothing about the ATmega32.
+ *
+ * Usage: bench [-t seconds] [-j result.json]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hostboard.h"
+#include "uart/uart.h"
+#include "defines.h"
+
+#define BENCH_DEFAULT_SECONDS 1.0
+#define BENCH_STREAM_SIZE 8192u
+#define BENCH_BATCH_SIZE (UART_RX_BUFFER_SIZE - 1u)
+#define BENCH_MAX_BATCHES (BENCH_STREAM_SIZE / 8u)
+#define BENCH_RANDOM_SEED 12345u
+
+typedef struct
+{
+    uint8_t data[BENCH_STREAM_SIZE];
+    size_t length;
+    /* Batch ends, every batch holds whole input frames */
+    size_t batchEnd[BENCH_MAX_BATCHES];
+    size_t batches;
+    size_t frames;
+} ts_BENCH_Stream;
+
+typedef void (*tf_BENCH_Frame)(uint8_t frame[], size_t *length, unsigned int idx);
+
+typedef struct
+{
+    const char *name;
+    tf_BENCH_Frame makeFrame;
+} ts_BENCH_Workload;
+
+static const char *BENCH_validBodies[] = {
+    "led11", "led20", "lcd00Hello", "lcd14host bench", "get9", "get04", "sts", "@led11",
+};
+
+static void BENCH_Frame(uint8_t frame[], size_t *length, const char *body)
+{
+    *length = (size_t)sprintf((char *)frame, "ASK%02X%sEND\n", (unsigned int)strlen(body), body);
+}
+
+static void BENCH_ValidFrame(uint8_t frame[], size_t *length, unsigned int idx)
+{
+    BENCH_Frame(frame, length, BENCH_validBodies[idx % (sizeof(BENCH_validBodies) / sizeof(BENCH_validBodies[0]))]);
+}
+
+/* Well-formed frames the dispatcher refuses */
+static void BENCH_RefusedFrame(uint8_t frame[], size_t *length, unsigned int idx)
+{
+    static const char *bodies[] = { "xyz", "led", "led1X", "lcd3", "get**", "bat03zzz" };
+
+    BENCH_Frame(frame, length, bodies[idx % (sizeof(bodies) / sizeof(bodies[0]))]);
+}
+
+/* Lines of random bytes */
+static void BENCH_NoiseFrame(uint8_t frame[], size_t *length, unsigned int idx)
+{
+    size_t pos = 0u;
+    size_t noiseLength = 8u + ((size_t)rand() % 24u);
+
+    (void)idx;
+    for(pos = 0u; pos < noiseLength; pos++)
+    {
+        frame[pos] = (uint8_t)rand();
+        if(frame[pos] == '\n')
+        {
+            frame[pos] = 0u;
+        }
+    }
+    frame[pos] = '\n';
+    *length = pos + 1u;
+}
+
+/* Broken frames that make the parser search and compare the most */
+static void BENCH_AdversarialFrame(uint8_t frame[], size_t *length, unsigned int idx)
+{
+    static const char *frames[] = {
+        "ASKASKASKASKASKASKASKASK\n",  /* start sequences only */
+        "ASK05led1END\n",              /* length longer than body */
+        "ASK03led11END\n",             /* length shorter than body */
+        "ASKFFled11END\n",             /* length over the maximum */
+        "ASKZZled11END\n",             /* length is not hex */
+        "ASK05led11EN\n",              /* broken stop sequence */
+        "ASK0",                        /* frame cut at a batch end */
+        "ENDENDASK05led11ASKEND\n",    /* sequences in wrong order */
+    };
+    const char *text = frames[idx % (sizeof(frames) / sizeof(frames[0]))];
+
+    *length = strlen(text);
+    memcpy(frame, text, *length);
+}
+
+static const ts_BENCH_Workload BENCH_workloads[] = {
+    { "valid", BENCH_ValidFrame },
+    { "refused", BENCH_RefusedFrame },
+    { "noise", BENCH_NoiseFrame },
+    { "adversarial", BENCH_AdversarialFrame },
+};
+
+static void BENCH_BuildStream(ts_BENCH_Stream *stream, tf_BENCH_Frame makeFrame)
+{
+    uint8_t frame[BENCH_BATCH_SIZE + 1u];
+    size_t frameLength = 0u;
+    size_t batchStart = 0u;
+    unsigned int idx = 0u;
+
+    memset(stream, 0, sizeof(ts_BENCH_Stream));
+    srand(BENCH_RANDOM_SEED);
+    while(stream->batches < BENCH_MAX_BATCHES)
+    {
+        makeFrame(frame, &frameLength, idx);
+        idx++;
+        if( (stream->length + frameLength) > BENCH_STREAM_SIZE )
+        {
+            break;
+        }
+        if( (stream->length + frameLength - batchStart) > BENCH_BATCH_SIZE )
+        {
+            stream->batchEnd[stream->batches] = stream->length;
+            stream->batches++;
+            batchStart = stream->length;
+        }
+        memcpy(&stream->data[stream->length], frame, frameLength);
+        stream->length += frameLength;
+        stream->frames++;
+    }
+    if( (stream->length > batchStart) && (stream->batches < BENCH_MAX_BATCHES) )
+    {
+        stream->batchEnd[stream->batches] = stream->length;
+        stream->batches++;
+    }
+}
+
+static double BENCH_Now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+}
+
+static void BENCH_Parse(void)
+{
+    uint8_t body[UART_MAX_BODY_LENGTH];
+    uint8_t length = 0u;
+    uint8_t error = ERR_NO_ERROR;
+
+    /* The same steps as CMD_Run, without the dispatcher */
+    if( (UART_Get_RX_newDataLength() > 0u) && (UART_RX_FetchBuffer() > 0u) )
+    {
+        do
+        {
+            error = ERR_NO_ERROR;
+            UART_RX_ReadPackage(body, &length, &error);
+        } while(UART_RX_IsPackagePending() == D_TRUE);
+    }
+}
+
+static void BENCH_Dispatch(void)
+{
+    HB_Tick();
+    HB_Drain(NULL);
+}
+
+/* Returns input frames per second */
+static double BENCH_Run(const ts_BENCH_Stream *stream, void (*stage)(void), const double seconds)
+{
+    size_t batchIdx = 0u;
+    size_t pos = 0u;
+    unsigned long frames = 0u;
+    double start = BENCH_Now();
+    double elapsed = 0.0;
+
+    do
+    {
+        pos = 0u;
+        for(batchIdx = 0u; batchIdx < stream->batches; batchIdx++)
+        {
+            for(; pos < stream->batchEnd[batchIdx]; pos++)
+            {
+                HB_Receive(stream->data[pos]);
+            }
+            stage();
+        }
+        frames += stream->frames;
+        elapsed = BENCH_Now() - start;
+    } while(elapsed < seconds);
+
+    return (double)frames / elapsed;
+}
+
+int main(int argc, char **argv)
+{
+    static ts_BENCH_Stream stream;
+    double seconds = BENCH_DEFAULT_SECONDS;
+    const char *jsonPath = NULL;
+    FILE *json = NULL;
+    double parseRate = 0.0;
+    double dispatchRate = 0.0;
+    size_t workloadIdx = 0u;
+    int option = 0;
+
+    while( (option = getopt(argc, argv, "t:j:")) != -1 )
+    {
+        switch(option)
+        {
+        case 't':
+            seconds = atof(optarg);
+            break;
+        case 'j':
+            jsonPath = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-t seconds] [-j result.json]\n", argv[0]);
+            return 1;
+        }
+    }
+    if(jsonPath != NULL)
+    {
+        json = fopen(jsonPath, "w");
+        if(json == NULL)
+        {
+            perror(jsonPath);
+            return 1;
+        }
+        fprintf(json, "{\n");
+    }
+
+    HB_Init();
+    printf("%-12s %8s %14s %14s\n", "workload", "frames", "parse fr/s", "dispatch fr/s");
+    for(workloadIdx = 0u; workloadIdx < (sizeof(BENCH_workloads) / sizeof(BENCH_workloads[0])); workloadIdx++)
+    {
+        BENCH_BuildStream(&stream, BENCH_workloads[workloadIdx].makeFrame);
+        parseRate = BENCH_Run(&stream, BENCH_Parse, seconds);
+        dispatchRate = BENCH_Run(&stream, BENCH_Dispatch, seconds);
+        printf("%-12s %8zu %14.0f %14.0f\n", BENCH_workloads[workloadIdx].name, stream.frames, parseRate, dispatchRate);
+        if(json != NULL)
+        {
+            fprintf(json, "  \"%s\": {\"parse_fps\": %.0f, \"dispatch_fps\": %.0f}%s\n", BENCH_workloads[workloadIdx].name,
+                parseRate, dispatchRate, ((workloadIdx + 1u) < (sizeof(BENCH_workloads) / sizeof(BENCH_workloads[0]))) ? "," : "");
+        }
+    }
+    if(json != NULL)
+    {
+        fprintf(json, "}\n");
+        fclose(json);
+    }
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+/*
+ * libFuzzer target of the frame parser and command dispatcher.
+ *
+ * Input bytes are received by the USART one by one, the scheduler slot
+ * runs after every '\n' and whenever the RX ring could be full, like
+ * the 10 ms tick does on the board. Everything transmitted must be
+ * well-formed frames, otherwise the target aborts. Firmware state is
+ * kept between inputs, as it is on the board.
+ *
+ * Built with -DHB_STANDALONE the target gets a main() that runs files
+ * given as arguments, so it works without clang as well. With -r count
+ * it also runs count random inputs put together from protocol tokens.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "hostboard.h"
+#include "uart/uart.h"
+#include "cmd/cmd.h"
+
+/* Deferred commands are retried for about this number of ticks */
+#define FUZZ_SETTLE_TICKS (CMD_DEFER_MAX_RETRIES + 2u)
+
+static ts_HB_Capture FUZZ_capture;
+static int FUZZ_initialized = 0;
+static unsigned long FUZZ_frames = 0u;
+
+static void FUZZ_Tick(void)
+{
+    size_t brokenPos = 0u;
+
+    FUZZ_capture.length = 0u;
+    HB_Tick();
+    HB_Drain(&FUZZ_capture);
+    brokenPos = HB_CheckFrames(&FUZZ_capture);
+    if(brokenPos != 0u)
+    {
+        fprintf(stderr, "broken frame at offset %zu of %zu transmitted bytes:\n", brokenPos - 1u, FUZZ_capture.length);
+        fwrite(FUZZ_capture.data, 1u, FUZZ_capture.length, stderr);
+        fputc('\n', stderr);
+        abort();
+    }
+    FUZZ_frames += FUZZ_capture.frames;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    size_t idx = 0u;
+    size_t sinceTick = 0u;
+    unsigned int tick = 0u;
+
+    if(FUZZ_initialized == 0)
+    {
+        HB_Init();
+        FUZZ_initialized = 1;
+    }
+    for(idx = 0u; idx < size; idx++)
+    {
+        HB_Receive(data[idx]);
+        sinceTick++;
+        if( (data[idx] == '\n') || (sinceTick >= (UART_RX_BUFFER_SIZE - 1u)) )
+        {
+            FUZZ_Tick();
+            sinceTick = 0u;
+        }
+    }
+    /* Queued and deferred commands are answered before the next input */
+    for(tick = 0u; tick < FUZZ_SETTLE_TICKS; tick++)
+    {
+        FUZZ_Tick();
+    }
+
+    return 0;
+}
+
+#ifdef HB_STANDALONE
+#include <string.h>
+
+#define FUZZ_RANDOM_INPUT_SIZE 512u
+#define FUZZ_RANDOM_SEED 1u
+
+static const char *FUZZ_tokens[] = {
+    "ASK", "END\n", "\n", "@", "05", "0A", "FF", "00", "3F", "led11", "lcd0", "old2", "mot0", "bip1", "get", "*",
+    "sts", "adr", "bat", "mrd0", "mrd2", "mwr1", "mwr2", "scw0", "scd0", "scrTST", "scs", "TST", "0000", "FFFF", "ZZ",
+};
+
+static size_t FUZZ_RandomInput(uint8_t input[], const size_t size)
+{
+    size_t length = 0u;
+    size_t tokenLength = 0u;
+    const char *token = NULL;
+    uint8_t byte = 0u;
+
+    while(length < size)
+    {
+        if((rand() % 8) == 0)
+        {
+            byte = (uint8_t)rand();
+            token = (const char *)&byte;
+            tokenLength = 1u;
+        } else
+        {
+            token = FUZZ_tokens[(size_t)rand() % (sizeof(FUZZ_tokens) / sizeof(FUZZ_tokens[0]))];
+            tokenLength = strlen(token);
+        }
+        if((length + tokenLength) > size)
+        {
+            tokenLength = size - length;
+        }
+        memcpy(&input[length], token, tokenLength);
+        length += tokenLength;
+    }
+
+    return length;
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t input[1u << 16];
+    size_t size = 0u;
+    FILE *file = NULL;
+    unsigned long randomInputs = 0u;
+    unsigned long inputs = 0u;
+    int argIdx = 0;
+
+    for(argIdx = 1; argIdx < argc; argIdx++)
+    {
+        if( (strcmp(argv[argIdx], "-r") == 0) && ((argIdx + 1) < argc) )
+        {
+            argIdx++;
+            randomInputs = strtoul(argv[argIdx], NULL, 0);
+            continue;
+        }
+        file = fopen(argv[argIdx], "rb");
+        if(file == NULL)
+        {
+            perror(argv[argIdx]);
+            return 1;
+        }
+        size = fread(input, 1u, sizeof(input), file);
+        fclose(file);
+        (void)LLVMFuzzerTestOneInput(input, size);
+        inputs++;
+    }
+    srand(FUZZ_RANDOM_SEED);
+    for(; randomInputs > 0u; randomInputs--)
+    {
+        size = FUZZ_RandomInput(input, 1u + ((size_t)rand() % FUZZ_RANDOM_INPUT_SIZE));
+        (void)LLVMFuzzerTestOneInput(input, size);
+        inputs++;
+    }
+    printf("%lu inputs ok, %lu frames transmitted\n", inputs, FUZZ_frames);
+
+    return 0;
+}
+#endif
@@ -0,0 +1,118 @@
+#include "hostboard.h"
+
+#include <string.h>
+
+#include <avr/io.h>
+#include "uart/uart.h"
+#include "cmd/cmd.h"
+#include "script/script.h"
+#include "job/job.h"
+#include "buzzer/buzzer.h"
+#include "memaccess/memaccess.h"
+
+/* Interrupt vectors of the firmware, plain functions in the host build */
+extern void USART_RXC_vect(void);
+extern void USART_TXC_vect(void);
+
+#define HB_CHANNEL_QUANTITY 3u
+
+static const uint8_t HB_startSeq[UART_START_SEQ_LENGTH] = {'A', 'S', 'K'};
+static const uint8_t HB_stopSeq[UART_STOP_SEQ_LENGTH] = {'E', 'N', 'D', '\n'};
+
+static int HB_HexDigit(const uint8_t ch)
+{
+    int retVal = -1;
+
+    if( (ch >= '0') && (ch <= '9') )
+    {
+        retVal = ch - '0';
+    } else
+    if( (ch >= 'A') && (ch <= 'F') )
+    {
+        retVal = (ch - 'A') + 10;
+    }
+
+    return retVal;
+}
+
+void HB_Init(void)
+{
+    UART_Init();
+    CMD_Init();
+    SCR_Init();
+    JOB_Init();
+    STUB_udr = STUB_UDR_EMPTY;
+}
+
+void HB_Receive(const uint8_t byte)
+{
+    /* No line errors, MPCM bit is kept as the firmware set it */
+    UCSRA &= (uint8_t)(1u << MPCM);
+    STUB_udr = byte;
+    USART_RXC_vect();
+    STUB_udr = STUB_UDR_EMPTY;
+}
+
+void HB_Tick(void)
+{
+    BZ_Run();
+    CMD_Run();
+    SCR_Run();
+    JOB_Run();
+    MEM_Run();
+}
+
+void HB_Drain(ts_HB_Capture *capture)
+{
+    /* The byte written when transmitter was kicked off is in UDR already,
+       every TX complete interrupt writes the next one */
+    while(STUB_udr != STUB_UDR_EMPTY)
+    {
+        if( (capture != NULL) && (capture->length < HB_TX_CAPTURE_SIZE) )
+        {
+            capture->data[capture->length] = (uint8_t)STUB_udr;
+            capture->length++;
+        }
+        STUB_udr = STUB_UDR_EMPTY;
+        USART_TXC_vect();
+    }
+}
+
+size_t HB_CheckFrames(ts_HB_Capture *capture)
+{
+    size_t pos = 0u;
+    size_t retVal = 0u;
+    int high = 0;
+    int low = 0;
+    size_t bodyLength = 0u;
+
+    capture->frames = 0u;
+    while( (retVal == 0u) && (pos < capture->length) )
+    {
+        /* ASK, channel digit, 2 hex digits of body length, body, END\n */
+        if( ((capture->length - pos) < (UART_FRAME_HEADER_LENGTH + UART_STOP_SEQ_LENGTH)) ||
+            (memcmp(&capture->data[pos], HB_startSeq, UART_START_SEQ_LENGTH) != 0) ||
+            (capture->data[pos + UART_START_SEQ_LENGTH] < '0') ||
+            (capture->data[pos + UART_START_SEQ_LENGTH] >= ('0' + HB_CHANNEL_QUANTITY)) )
+        {
+            retVal = pos + 1u;
+        } else
+        {
+            high = HB_HexDigit(capture->data[pos + UART_START_SEQ_LENGTH + UART_CHANNEL_ID_LENGTH]);
+            low = HB_HexDigit(capture->data[pos + UART_START_SEQ_LENGTH + UART_CHANNEL_ID_LENGTH + 1u]);
+            bodyLength = (size_t)((high << 4) | low);
+            if( (high < 0) || (low < 0) || (bodyLength > UART_MAX_BODY_LENGTH) ||
+                ((capture->length - pos) < (UART_FRAME_HEADER_LENGTH + bodyLength + UART_STOP_SEQ_LENGTH)) ||
+                (memcmp(&capture->data[pos + UART_FRAME_HEADER_LENGTH + bodyLength], HB_stopSeq, UART_STOP_SEQ_LENGTH) != 0) )
+            {
+                retVal = pos + 1u;
+            } else
+            {
+                pos += UART_FRAME_HEADER_LENGTH + bodyLength + UART_STOP_SEQ_LENGTH;
+                capture->frames++;
+            }
+        }
+    }
+
+    return retVal;
+}
@@ -0,0 +1,35 @@
+/*
+ * hostboard - drives the firmware modules compiled for the Linux host:
+ * bytes are fed through the USART RX interrupt, the scheduler slots that
+ * handle commands are run by hand and transmitted bytes are taken from
+ * UDR in the TX complete interrupt.
+ */
+#ifndef hostboard_h
+#define hostboard_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Holds everything transmitted while a whole USART RX ring is handled */
+#define HB_TX_CAPTURE_SIZE 4096u
+
+typedef struct
+{
+    uint8_t data[HB_TX_CAPTURE_SIZE];
+    size_t length;
+    /* Frames found by HB_CheckFrames */
+    size_t frames;
+} ts_HB_Capture;
+
+extern void HB_Init(void);
+/* One byte received by the USART */
+extern void HB_Receive(const uint8_t byte);
+/* One 10 ms scheduler slot: command dispatcher, scripts, jobs and EEPROM writes */
+extern void HB_Tick(void);
+/* Moves transmitted bytes to capture, NULL capture drops them */
+extern void HB_Drain(ts_HB_Capture *capture);
+/* Returns 0 if capture is a sequence of well-formed frames,
+   otherwise offset of the first broken frame plus 1 */
+extern size_t HB_CheckFrames(ts_HB_Capture *capture);
+
+#endif
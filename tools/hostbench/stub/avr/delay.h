@@ -0,0 +1 @@
+#include <util/delay.h>
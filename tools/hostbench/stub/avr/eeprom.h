@@ -0,0 +1,16 @@
+/* Host build stub of <avr/eeprom.h>: EEMEM variables live in host RAM */
+#ifndef STUB_EEPROM_H
+#define STUB_EEPROM_H
+#include <stdint.h>
+#include <stddef.h>
+
+#define EEMEM
+#define eeprom_is_ready() 1
+
+extern uint8_t eeprom_read_byte(const uint8_t *address);
+extern void eeprom_write_byte(uint8_t *address, uint8_t value);
+extern void eeprom_update_byte(uint8_t *address, uint8_t value);
+extern void eeprom_read_block(void *dst, const void *src, size_t length);
+extern void eeprom_update_block(const void *src, void *dst, size_t length);
+
+#endif
@@ -0,0 +1,11 @@
+/* Host build stub of <avr/interrupt.h>: ISRs become plain functions,
+   the host calls them to simulate interrupts */
+#ifndef STUB_INTERRUPT_H
+#define STUB_INTERRUPT_H
+#include <avr/io.h>
+
+#define ISR(vector) void vector(void); void vector(void)
+#define sei()
+#define cli()
+
+#endif
@@ -0,0 +1,160 @@
+/* Host build stub of <avr/io.h> for ATmega32: I/O registers are plain
+   memory. UDR is kept apart and is 16 bit wide, so the host can tell a
+   byte written by the firmware from STUB_UDR_EMPTY */
+#ifndef STUB_IO_H
+#define STUB_IO_H
+#include <stdint.h>
+
+#define STUB_IO_SPACE_SIZE 0x60
+#define STUB_UDR_EMPTY 0xFFFFu
+
+extern volatile uint8_t STUB_ioSpace[STUB_IO_SPACE_SIZE];
+extern volatile uint16_t STUB_udr;
+/* Data space by address, for code that takes addresses as numbers */
+extern volatile uint8_t STUB_dataSpace[];
+#define _SFR_MEM8(address) (STUB_dataSpace[(uint16_t)(address)])
+#define _SFR_IO8(a) (STUB_ioSpace[(a)])
+#define _SFR_IO16(a) (*(volatile uint16_t*)&STUB_ioSpace[(a)])
+#define _BV(b) (1<<(b))
+#define TWBR _SFR_IO8(0x20)
+#define TWSR _SFR_IO8(0x21)
+#define TWAR _SFR_IO8(0x22)
+#define TWDR _SFR_IO8(0x23)
+#define ADCL _SFR_IO8(0x24)
+#define ADCH _SFR_IO8(0x25)
+#define ADCW _SFR_IO16(0x24)
+#define ADCSRA _SFR_IO8(0x26)
+#define ADMUX _SFR_IO8(0x27)
+#define UBRRL _SFR_IO8(0x29)
+#define UCSRB _SFR_IO8(0x2A)
+#define UCSRA _SFR_IO8(0x2B)
+#define UDR STUB_udr
+#define PIND _SFR_IO8(0x30)
+#define DDRD _SFR_IO8(0x31)
+#define PORTD _SFR_IO8(0x32)
+#define PINC _SFR_IO8(0x33)
+#define DDRC _SFR_IO8(0x34)
+#define PORTC _SFR_IO8(0x35)
+#define PINB _SFR_IO8(0x36)
+#define DDRB _SFR_IO8(0x37)
+#define PORTB _SFR_IO8(0x38)
+#define PINA _SFR_IO8(0x39)
+#define DDRA _SFR_IO8(0x3A)
+#define PORTA _SFR_IO8(0x3B)
+#define EECR _SFR_IO8(0x3C)
+#define EEDR _SFR_IO8(0x3D)
+#define EEAR _SFR_IO16(0x3E)
+#define UBRRH _SFR_IO8(0x40)
+#define UCSRC _SFR_IO8(0x40)
+#define ASSR _SFR_IO8(0x42)
+#define OCR2 _SFR_IO8(0x43)
+#define TCNT2 _SFR_IO8(0x44)
+#define TCCR2 _SFR_IO8(0x45)
+#define ICR1 _SFR_IO16(0x46)
+#define OCR1B _SFR_IO16(0x48)
+#define OCR1A _SFR_IO16(0x4A)
+#define TCNT1 _SFR_IO16(0x4C)
+#define TCCR1B _SFR_IO8(0x4E)
+#define TCCR1A _SFR_IO8(0x4F)
+#define SFIOR _SFR_IO8(0x50)
+#define TCNT0 _SFR_IO8(0x52)
+#define TCCR0 _SFR_IO8(0x53)
+#define MCUCSR _SFR_IO8(0x54)
+#define MCUCR _SFR_IO8(0x55)
+#define TWCR _SFR_IO8(0x56)
+#define TIFR _SFR_IO8(0x58)
+#define TIMSK _SFR_IO8(0x59)
+#define GIFR _SFR_IO8(0x5A)
+#define GICR _SFR_IO8(0x5B)
+#define OCR0 _SFR_IO8(0x5C)
+#define SREG _SFR_IO8(0x5F)
+#define RAMEND 0x85F
+#define E2END 0x3FF
+/* bits */
+#define TWINT 7
+#define TWEA 6
+#define TWSTA 5
+#define TWSTO 4
+#define TWWC 3
+#define TWEN 2
+#define TWIE 0
+#define ADEN 7
+#define ADSC 6
+#define REFS1 7
+#define REFS0 6
+#define RXC 7
+#define TXC 6
+#define UDRE 5
+#define FE 4
+#define DOR 3
+#define PE 2
+#define U2X 1
+#define MPCM 0
+#define RXCIE 7
+#define TXCIE 6
+#define UDRIE 5
+#define RXEN 4
+#define TXEN 3
+#define UCSZ2 2
+#define RXB8 1
+#define TXB8 0
+#define URSEL 7
+#define UMSEL 6
+#define UPM1 5
+#define UPM0 4
+#define USBS 3
+#define UCSZ1 2
+#define UCSZ0 1
+#define UCPOL 0
+#define OCIE2 7
+#define TOIE2 6
+#define TICIE1 5
+#define OCIE1A 4
+#define OCIE1B 3
+#define TOIE1 2
+#define OCIE0 1
+#define TOIE0 0
+#define OCF2 7
+#define OCF1A 4
+#define OCF1B 3
+#define TOV1 2
+#define OCF0 1
+#define FOC0 7
+#define WGM00 6
+#define COM01 5
+#define COM00 4
+#define WGM01 3
+#define CS02 2
+#define CS01 1
+#define CS00 0
+#define FOC2 7
+#define WGM20 6
+#define COM21 5
+#define COM20 4
+#define WGM21 3
+#define CS22 2
+#define CS21 1
+#define CS20 0
+#define WGM13 4
+#define WGM12 3
+#define CS12 2
+#define CS11 1
+#define CS10 0
+#define INT1 7
+#define INT0 6
+#define INT2 5
+#define INTF1 7
+#define INTF0 6
+#define INTF2 5
+#define ISC11 3
+#define ISC10 2
+#define ISC01 1
+#define ISC00 0
+#define ISC2 6
+#define PSR2 1
+#define PSR10 0
+#define EERIE 3
+#define EEMWE 2
+#define EEWE 1
+#define EERE 0
+#endif
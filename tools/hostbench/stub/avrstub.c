@@ -0,0 +1,60 @@
+/* Memory behind the stub registers and EEPROM functions of the host build */
+#include <string.h>
+#include <stdint.h>
+#include <avr/io.h>
+#include <avr/eeprom.h>
+
+volatile uint8_t STUB_ioSpace[STUB_IO_SPACE_SIZE];
+volatile uint16_t STUB_udr = STUB_UDR_EMPTY;
+volatile uint8_t STUB_dataSpace[RAMEND + 1];
+
+/* EEMEM variables are host RAM and their addresses are real pointers,
+   addresses given as numbers are taken from this array */
+static uint8_t STUB_eeprom[E2END + 1];
+
+static uint8_t *STUB_EepromByte(const uint8_t *address)
+{
+    uint8_t *retVal = (uint8_t *)address;
+
+    if((uintptr_t)address <= E2END)
+    {
+        retVal = &STUB_eeprom[(uintptr_t)address];
+    }
+
+    return retVal;
+}
+
+uint8_t eeprom_read_byte(const uint8_t *address)
+{
+    return *STUB_EepromByte(address);
+}
+
+void eeprom_write_byte(uint8_t *address, uint8_t value)
+{
+    *STUB_EepromByte(address) = value;
+}
+
+void eeprom_update_byte(uint8_t *address, uint8_t value)
+{
+    *STUB_EepromByte(address) = value;
+}
+
+void eeprom_read_block(void *dst, const void *src, size_t length)
+{
+    size_t idx = 0u;
+
+    for(idx = 0u; idx < length; idx++)
+    {
+        ((uint8_t *)dst)[idx] = eeprom_read_byte((const uint8_t *)src + idx);
+    }
+}
+
+void eeprom_update_block(const void *src, void *dst, size_t length)
+{
+    size_t idx = 0u;
+
+    for(idx = 0u; idx < length; idx++)
+    {
+        eeprom_update_byte((uint8_t *)dst + idx, ((const uint8_t *)src)[idx]);
+    }
+}
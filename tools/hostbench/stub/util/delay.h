@@ -0,0 +1,8 @@
+/* Host build stub of <util/delay.h>: busy waits take no time */
+#ifndef STUB_DELAY_H
+#define STUB_DELAY_H
+
+#define _delay_ms(ms)
+#define _delay_us(us)
+
+#endif
@@ -0,0 +1,14 @@
+/* Host build stub of <util/twi.h>: TWI status codes used by the firmware */
+#ifndef STUB_TWI_H
+#define STUB_TWI_H
+
+#define TW_START 0x08
+#define TW_REP_START 0x10
+#define TW_MT_SLA_ACK 0x18
+#define TW_MT_DATA_ACK 0x28
+#define TW_MR_SLA_ACK 0x40
+#define TW_MR_DATA_ACK 0x50
+#define TW_MR_DATA_NACK 0x58
+#define TW_NO_INFO 0xF8
+
+#endif
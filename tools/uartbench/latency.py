@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+"""
+Breaks command round-trip latency into stages using firmware timestamps.
+
+Every request body gets '@' in front of it, so the board answers with
+'@' followed by four 16-bit hex timestamps (TT_TIMESTAMP_TICK_US units):
+rx start, rx complete, dispatch and response enqueue. Stages are:
+
+    rx wire    rx start    -> rx complete   request bytes on the wire
+    rx queue   rx complete -> dispatch      waiting for the CMD_Run tick
+    execute    dispatch    -> enqueue       parsing and command execution
+    tx + host  round trip - (enqueue - rx start)
+                                            response on the wire, host and
+                                            pty latencies, request first byte
+
+Requests are sent one at a time, so stages of different commands do not
+overlap. Histograms of every stage are printed as text.
+
+Example:
+    latency.py --port /tmp/simuart --count 500 --mix led=4,lcd=2,bip=1
+"""
+import argparse
+import json
+import os
+import random
+import sys
+import time
+
+from uartbench import COMMAND_BODIES, CHANNEL_CMD, FrameParser, drain, make_frame, open_port, parse_mix, percentile
+
+TIMESTAMP_MARK = b"@"
+TIMESTAMP_QUANTITY = 4
+TIMESTAMP_DIGITS = 4
+TICK_US = 4
+STAGES = ["rx wire", "rx queue", "execute", "tx + host", "total"]
+
+
+def parse_stamps(body):
+    """Returns (status body, [rx start, rx complete, dispatch, enqueue]) or None."""
+    pos = body.rfind(TIMESTAMP_MARK)
+    digits = TIMESTAMP_QUANTITY * TIMESTAMP_DIGITS
+    if pos < 0 or len(body) - pos - 1 != digits:
+        return None
+    stamps = [int(body[pos + 1 + i * TIMESTAMP_DIGITS:pos + 1 + (i + 1) * TIMESTAMP_DIGITS], 16)
+              for i in range(TIMESTAMP_QUANTITY)]
+    return body[:pos], stamps
+
+
+def ticks_to_ms(start, end):
+    # Stamps are 16-bit and wrap, so only differences mod 2^16 are valid
+    return ((end - start) & 0xFFFF) * TICK_US / 1000.0
+
+
+def histogram(values, bins, width):
+    lines = []
+    if not values:
+        return lines
+    low = min(values)
+    high = max(values)
+    step = (high - low) / bins if high > low else 1.0
+    counts = [0] * bins
+    for value in values:
+        counts[min(bins - 1, int((value - low) / step))] += 1
+    top = max(counts)
+    for idx, count in enumerate(counts):
+        bar = "#" * int(round(width * count / top)) if top else ""
+        lines.append("  %8.3f ms %6d %s" % (low + idx * step, count, bar))
+    return lines
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--port", default="/tmp/simuart", help="serial port or pty path")
+    ap.add_argument("--baud", type=int, default=None, help="baud rate for real serial ports")
+    ap.add_argument("--mix", default="led=4,lcd=2,bip=1,old=1", help="command weights")
+    ap.add_argument("--count", type=int, default=200, help="number of requests")
+    ap.add_argument("--timeout", type=float, default=0.5, help="seconds to wait for a response")
+    ap.add_argument("--gap", type=float, default=0.0, help="random pause up to this many seconds between requests")
+    ap.add_argument("--bins", type=int, default=12, help="histogram bins")
+    ap.add_argument("--seed", type=int, default=1, help="random seed of the command mix")
+    ap.add_argument("--json", help="write samples to this file")
+    args = ap.parse_args()
+
+    mix = parse_mix(args.mix)
+    names = [name for name, _ in mix]
+    weights = [weight for _, weight in mix]
+    rng = random.Random(args.seed)
+
+    fd = open_port(args.port, args.baud)
+    parser = FrameParser()
+    samples = {stage: [] for stage in STAGES}
+    lost = 0
+
+    for _ in range(args.count):
+        body = TIMESTAMP_MARK + rng.choice(COMMAND_BODIES[rng.choices(names, weights)[0]])
+        sent = time.monotonic()
+        os.write(fd, make_frame(body))
+        answer = None
+        while answer is None and time.monotonic() - sent < args.timeout:
+            for channel, frame in drain(fd, parser, 0.001):
+                if channel == CHANNEL_CMD and answer is None:
+                    answer = parse_stamps(frame)
+        received = time.monotonic()
+        if answer is None:
+            lost += 1
+            continue
+        _, (rx_start, rx_complete, dispatch, enqueue) = answer
+        total = (received - sent) * 1000.0
+        on_board = ticks_to_ms(rx_start, enqueue)
+        samples["rx wire"].append(ticks_to_ms(rx_start, rx_complete))
+        samples["rx queue"].append(ticks_to_ms(rx_complete, dispatch))
+        samples["execute"].append(ticks_to_ms(dispatch, enqueue))
+        samples["tx + host"].append(max(0.0, total - on_board))
+        samples["total"].append(total)
+        if args.gap > 0.0:
+            time.sleep(rng.uniform(0.0, args.gap))
+    os.close(fd)
+
+    print("%-10s %9s %9s %9s %9s" % ("stage", "p50 ms", "p99 ms", "max ms", "mean ms"))
+    for stage in STAGES:
+        values = samples[stage]
+        mean = sum(values) / len(values) if values else float("nan")
+        print("%-10s %9.3f %9.3f %9.3f %9.3f" % (
+            stage, percentile(values, 50), percentile(values, 99), max(values or [float("nan")]), mean))
+    print("lost: %d of %d" % (lost, args.count))
+    for stage in STAGES:
+        print("")
+        print(stage)
+        for line in histogram(samples[stage], args.bins, 50):
+            print(line)
+    sys.stdout.flush()
+
+    if args.json:
+        with open(args.json, "w") as out:
+            json.dump({"mix": args.mix, "count": args.count, "lost": lost, "samples_ms": samples}, out, indent=2)
+
+
+if __name__ == "__main__":
+    main()
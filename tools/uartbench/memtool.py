@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""
+Reads and writes memory of the running board with the mrd/mwr commands
+(see src/memaccess/memaccess.h). Targets are given as:
+
+    OLED_buffer+16     symbol from the firmware ELF, with optional offset
+    TWSR               I/O register of the ATmega32
+    sram:0x0100        address in a space (sram, io, eeprom)
+
+Symbols are resolved with avr-nm, SRAM symbols lie at 0x800000 and
+EEPROM ones at 0x810000 in the ELF. Ranges longer than one frame are
+split into several requests.
+
+Example:
+    memtool.py --elf .pio/build/ATmega32/firmware.elf read LCD_currentPoint
+    memtool.py --elf firmware.elf read OLED_buffer 128
+    memtool.py write PORTC 0F
+"""
+import argparse
+import os
+import subprocess
+import sys
+import time
+
+from uartbench import CHANNEL_CMD, FrameParser, drain, make_frame, open_port
+
+SPACE_SRAM = 0
+SPACE_IO = 1
+SPACE_EEPROM = 2
+SPACES = {"sram": SPACE_SRAM, "io": SPACE_IO, "eeprom": SPACE_EEPROM}
+ELF_SRAM_BASE = 0x800000
+ELF_EEPROM_BASE = 0x810000
+ELF_SECTION_MASK = 0xFF0000
+MAX_BODY_LENGTH = 52
+MAX_READ_LENGTH = (MAX_BODY_LENGTH - 3) // 2
+MAX_WRITE_LENGTH = (MAX_BODY_LENGTH - (3 + 1 + 4)) // 2
+READ_TAG = b"MRD"
+OK = b"_OK_"
+BUSY = b"_MEMBUSY_"
+# I/O addresses of ATmega32 registers (data address minus 0x20)
+IO_REGISTERS = {
+    "TWBR": 0x00, "TWSR": 0x01, "TWAR": 0x02, "TWDR": 0x03, "ADCL": 0x04, "ADCH": 0x05,
+    "ADCSRA": 0x06, "ADMUX": 0x07, "ACSR": 0x08, "UBRRL": 0x09, "UCSRB": 0x0A, "UCSRA": 0x0B,
+    "UDR": 0x0C, "SPCR": 0x0D, "SPSR": 0x0E, "SPDR": 0x0F, "PIND": 0x10, "DDRD": 0x11,
+    "PORTD": 0x12, "PINC": 0x13, "DDRC": 0x14, "PORTC": 0x15, "PINB": 0x16, "DDRB": 0x17,
+    "PORTB": 0x18, "PINA": 0x19, "DDRA": 0x1A, "PORTA": 0x1B, "EECR": 0x1C, "EEDR": 0x1D,
+    "EEARL": 0x1E, "EEARH": 0x1F, "UCSRC": 0x20, "WDTCR": 0x21, "ASSR": 0x22, "OCR2": 0x23,
+    "TCNT2": 0x24, "TCCR2": 0x25, "ICR1L": 0x26, "ICR1H": 0x27, "OCR1BL": 0x28, "OCR1BH": 0x29,
+    "OCR1AL": 0x2A, "OCR1AH": 0x2B, "TCNT1L": 0x2C, "TCNT1H": 0x2D, "TCCR1B": 0x2E, "TCCR1A": 0x2F,
+    "SFIOR": 0x30, "OSCCAL": 0x31, "TCNT0": 0x32, "TCCR0": 0x33, "MCUCSR": 0x34, "MCUCR": 0x35,
+    "TWCR": 0x36, "SPMCR": 0x37, "TIFR": 0x38, "TIMSK": 0x39, "GIFR": 0x3A, "GICR": 0x3B,
+    "OCR0": 0x3C, "SPL": 0x3D, "SPH": 0x3E, "SREG": 0x3F,
+}
+
+
+def load_symbols(elf, nm):
+    """Returns {name: (space, address, size)} of data and EEPROM symbols."""
+    symbols = {}
+    output = subprocess.run([nm, "-S", elf], check=True, capture_output=True, text=True).stdout
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) != 4:
+            continue
+        address, size, _, name = int(fields[0], 16), int(fields[1], 16), fields[2], fields[3]
+        if address & ELF_SECTION_MASK == ELF_SRAM_BASE:
+            symbols[name] = (SPACE_SRAM, address - ELF_SRAM_BASE, size)
+        elif address & ELF_SECTION_MASK == ELF_EEPROM_BASE:
+            symbols[name] = (SPACE_EEPROM, address - ELF_EEPROM_BASE, size)
+    return symbols
+
+
+def resolve(target, symbols):
+    """Returns (space, address, size) of the target, size 1 if unknown."""
+    if ":" in target:
+        space, address = target.split(":", 1)
+        return SPACES[space], int(address, 0), 1
+    name, _, offset = target.partition("+")
+    offset = int(offset, 0) if offset else 0
+    if name.upper() in IO_REGISTERS:
+        return SPACE_IO, IO_REGISTERS[name.upper()] + offset, 1
+    if name not in symbols:
+        sys.exit("unknown symbol %s (pass --elf?)" % name)
+    space, address, size = symbols[name]
+    return space, address + offset, max(size - offset, 1)
+
+
+def request(fd, parser, body, timeout, retries):
+    """Sends body until it is not answered busy, returns the answer."""
+    for _ in range(retries):
+        os.write(fd, make_frame(body))
+        end = time.monotonic() + timeout
+        answer = None
+        while answer is None and time.monotonic() < end:
+            for channel, frame in drain(fd, parser, 0.01):
+                if channel == CHANNEL_CMD and answer is None:
+                    answer = frame
+        if answer != BUSY:
+            return answer
+        time.sleep(0.05)
+    return BUSY
+
+
+def read(fd, parser, space, address, length, args):
+    data = bytearray()
+    while len(data) < length:
+        count = min(MAX_READ_LENGTH, length - len(data))
+        body = b"mrd%X%04X%02X" % (space, address + len(data), count)
+        answer = request(fd, parser, body, args.timeout, args.retries)
+        if answer is None or not answer.startswith(READ_TAG):
+            sys.exit("%s: %s" % (body.decode(), answer))
+        data += bytes.fromhex(answer[len(READ_TAG):].decode())
+    return bytes(data)
+
+
+def write(fd, parser, space, address, data, args):
+    for offset in range(0, len(data), MAX_WRITE_LENGTH):
+        chunk = data[offset:offset + MAX_WRITE_LENGTH]
+        body = b"mwr%X%04X" % (space, address + offset) + chunk.hex().upper().encode()
+        answer = request(fd, parser, body, args.timeout, args.retries)
+        if answer != OK:
+            sys.exit("%s: %s" % (body.decode(), answer))
+
+
+def hexdump(address, data):
+    for offset in range(0, len(data), 16):
+        line = data[offset:offset + 16]
+        text = "".join(chr(b) if 0x20 <= b < 0x7F else "." for b in line)
+        print("%04X  %-48s %s" % (address + offset, " ".join("%02X" % b for b in line), text))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("action", choices=["read", "write", "symbols"])
+    ap.add_argument("target", nargs="?", help="symbol[+offset], I/O register or space:address")
+    ap.add_argument("value", nargs="?", help="read: length in bytes, write: hex data")
+    ap.add_argument("--elf", help="firmware ELF for symbol addresses")
+    ap.add_argument("--nm", default="avr-nm", help="nm of the AVR toolchain")
+    ap.add_argument("--port", default="/tmp/simuart", help="serial port or pty path")
+    ap.add_argument("--baud", type=int, default=None, help="baud rate for real serial ports")
+    ap.add_argument("--timeout", type=float, default=0.5, help="seconds to wait for a response")
+    ap.add_argument("--retries", type=int, default=20, help="resends of a busy request")
+    args = ap.parse_args()
+
+    symbols = load_symbols(args.elf, args.nm) if args.elf else {}
+    if args.action == "symbols":
+        for name, (space, address, size) in sorted(symbols.items(), key=lambda item: item[1]):
+            print("%-6s %04X %5d %s" % ({v: k for k, v in SPACES.items()}[space], address, size, name))
+        return
+    if args.target is None:
+        sys.exit("target is missing")
+    space, address, size = resolve(args.target, symbols)
+
+    fd = open_port(args.port, args.baud)
+    parser = FrameParser()
+    if args.action == "read":
+        length = int(args.value, 0) if args.value else size
+        hexdump(address, read(fd, parser, space, address, length, args))
+    else:
+        if args.value is None:
+            sys.exit("data is missing")
+        write(fd, parser, space, address, bytes.fromhex(args.value), args)
+    os.close(fd)
+
+
+if __name__ == "__main__":
+    main()
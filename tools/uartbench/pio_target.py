@@ -0,0 +1,18 @@
+# PlatformIO extra script: adds "uartbench" custom target, so the
+# benchmark runs against the freshly built firmware with
+#   pio run -t uartbench
+import os
+
+Import("env")
+
+bench_dir = os.path.join(env.subst("$PROJECT_DIR"), "tools", "uartbench")
+
+env.AddCustomTarget(
+    name="uartbench",
+    dependencies="$BUILD_DIR/${PROGNAME}.elf",
+    actions=[
+        'make -C "%s" bench ELF="$BUILD_DIR/${PROGNAME}.elf"' % bench_dir
+    ],
+    title="UART bench",
+    description="Command throughput and latency benchmark in simavr"
+)
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+Reads device state back with the get command and prints it by name
+(see src/cmd/cmdquery.h for signal ids and encoding).
+
+Example:
+    query.py --port /tmp/simuart            # snapshot of all scalar signals
+    query.py --port /tmp/simuart --signals BC --json state.json
+"""
+import argparse
+import json
+import os
+import sys
+import time
+
+from uartbench import CHANNEL_CMD, FrameParser, drain, make_frame, open_port
+
+GET_TAG = b"GET"
+SNAPSHOT = "*"
+LCD_LENGTH = 32
+ETL_ERROR_DIGITS = 4
+# id: (name, hex digits); None digits are decoded by decode_signal
+SIGNALS = {
+    0x0: ("adc0", 4),
+    0x1: ("adc1", 4),
+    0x2: ("led_display", 4),
+    0x3: ("ticker_speed", 2),
+    0x4: ("motor_position", 4),
+    0x5: ("motor_steps", 4),
+    0x6: ("twi_busy", 1),
+    0x7: ("oled_settled", 1),
+    0x8: ("buzzer_active", 1),
+    0x9: ("node_address", 2),
+    0xA: ("etl_count", 2),
+    0xB: ("etl_errors", None),
+    0xC: ("lcd", None),
+}
+
+
+def decode_signal(signal, body, pos):
+    """Returns (name, value, next position)."""
+    name, digits = SIGNALS[signal]
+    if signal == 0xB:
+        count = int(body[pos:pos + 2], 16)
+        pos += 2
+        errors = []
+        for _ in range(count):
+            item = body[pos:pos + ETL_ERROR_DIGITS]
+            errors.append({"object": int(item[0:1], 16), "error": int(item[1:2], 16), "data": int(item[2:4], 16)})
+            pos += ETL_ERROR_DIGITS
+        return name, errors, pos
+    if signal == 0xC:
+        text = body[pos:pos + LCD_LENGTH].decode("latin-1")
+        return name, [text[:LCD_LENGTH // 2], text[LCD_LENGTH // 2:]], pos + LCD_LENGTH
+    value = int(body[pos:pos + digits], 16)
+    if name == "motor_position" and value >= 0x8000:
+        value -= 0x10000
+    return name, value, pos + digits
+
+
+def decode(body):
+    if not body.startswith(GET_TAG):
+        raise ValueError("not a GET response: %r" % body)
+    state = {}
+    pos = len(GET_TAG)
+    while pos < len(body):
+        signal = int(body[pos:pos + 1], 16)
+        name, value, pos = decode_signal(signal, body, pos + 1)
+        state[name] = value
+    return state
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--port", default="/tmp/simuart", help="serial port or pty path")
+    ap.add_argument("--baud", type=int, default=None, help="baud rate for real serial ports")
+    ap.add_argument("--signals", default=SNAPSHOT, help="hex signal ids, '*' for the snapshot")
+    ap.add_argument("--timeout", type=float, default=0.5, help="seconds to wait for a response")
+    ap.add_argument("--json", help="write the state to this file")
+    args = ap.parse_args()
+
+    fd = open_port(args.port, args.baud)
+    parser = FrameParser()
+    os.write(fd, make_frame(b"get" + args.signals.upper().encode()))
+    answer = None
+    end = time.monotonic() + args.timeout
+    while answer is None and time.monotonic() < end:
+        for channel, frame in drain(fd, parser, 0.01):
+            if channel == CHANNEL_CMD and answer is None:
+                answer = frame
+    os.close(fd)
+    if answer is None:
+        sys.exit("no response")
+    if not answer.startswith(GET_TAG):
+        sys.exit(answer.decode("latin-1"))
+    state = decode(answer)
+    for name, value in state.items():
+        print("%-15s %s" % (name, value))
+    if args.json:
+        with open(args.json, "w") as out:
+            json.dump(state, out, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""
+Uploads a command script into an EEPROM slot of the board (see
+src/script/script.h) and optionally starts it.
+
+Script file has one command per line, '#' starts a comment:
+
+    # delay in ms before the command, command body
+    0    led01
+    500  led11
+    500  lcd0EOK
+
+Delays are rounded to 10 ms ticks, up to 2.55 s per record. The slot is
+erased first, then written in scw chunks (the board answers _SCRBUSY_
+while the previous chunk is still being written to EEPROM, such chunks
+are resent) and finally defined with scd, which makes it valid.
+
+Example:
+    scrupload.py --port /tmp/simuart --slot 0 --name LED --loop --run leds.txt
+"""
+import argparse
+import os
+import sys
+import time
+
+from uartbench import CHANNEL_CMD, FrameParser, drain, make_frame, open_port
+
+SLOT_SIZE = 128
+TICK_MS = 10
+MAX_DELAY_TICKS = 0xFF
+MAX_COMMAND_LENGTH = 52
+# scw body is name, slot digit, offset and 2 hex digits per byte
+CHUNK_LENGTH = (MAX_COMMAND_LENGTH - (3 + 1 + 2)) // 2
+FLAG_AUTORUN = 0x01
+FLAG_LOOP = 0x02
+OK = b"_OK_"
+BUSY = b"_SCRBUSY_"
+
+
+def parse_script(path):
+    data = bytearray()
+    with open(path) as src:
+        for number, line in enumerate(src, 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            delay, command = line.split(None, 1)
+            ticks = int(round(float(delay) / TICK_MS))
+            command = command.strip().encode()
+            if ticks > MAX_DELAY_TICKS or not 0 < len(command) <= MAX_COMMAND_LENGTH:
+                raise ValueError("line %d: delay or command too long" % number)
+            data += bytes([ticks, len(command)]) + command
+    if len(data) > SLOT_SIZE:
+        raise ValueError("script is %d bytes, slot holds %d" % (len(data), SLOT_SIZE))
+    return bytes(data)
+
+
+def request(fd, parser, body, timeout, retries):
+    """Sends body until it is not answered busy, returns the status."""
+    for _ in range(retries):
+        os.write(fd, make_frame(body))
+        end = time.monotonic() + timeout
+        answer = None
+        while answer is None and time.monotonic() < end:
+            for channel, frame in drain(fd, parser, 0.01):
+                if channel == CHANNEL_CMD and answer is None:
+                    answer = frame
+        if answer != BUSY:
+            return answer
+        time.sleep(0.05)
+    return BUSY
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("script", help="script file")
+    ap.add_argument("--port", default="/tmp/simuart", help="serial port or pty path")
+    ap.add_argument("--baud", type=int, default=None, help="baud rate for real serial ports")
+    ap.add_argument("--slot", type=int, default=0, help="EEPROM slot")
+    ap.add_argument("--name", required=True, help="3 character script name")
+    ap.add_argument("--autorun", action="store_true", help="start the script at boot")
+    ap.add_argument("--loop", action="store_true", help="repeat the script until scs")
+    ap.add_argument("--run", action="store_true", help="start the script after upload")
+    ap.add_argument("--timeout", type=float, default=0.5, help="seconds to wait for a response")
+    ap.add_argument("--retries", type=int, default=20, help="resends of a busy request")
+    args = ap.parse_args()
+
+    name = args.name.encode()
+    if len(name) != 3:
+        sys.exit("name must be 3 characters")
+    data = parse_script(args.script)
+    flags = (FLAG_AUTORUN if args.autorun else 0) | (FLAG_LOOP if args.loop else 0)
+    slot = b"%X" % args.slot
+
+    fd = open_port(args.port, args.baud)
+    parser = FrameParser()
+    bodies = [b"scd" + slot + name + b"000"]
+    for offset in range(0, len(data), CHUNK_LENGTH):
+        chunk = data[offset:offset + CHUNK_LENGTH]
+        bodies.append(b"scw" + slot + b"%02X" % offset + chunk.hex().upper().encode())
+    bodies.append(b"scd" + slot + name + b"%02X%X" % (len(data), flags))
+    if args.run:
+        bodies.append(b"scr" + name)
+    for body in bodies:
+        status = request(fd, parser, body, args.timeout, args.retries)
+        if status != OK:
+            os.close(fd)
+            sys.exit("%s: %s" % (body.decode(), status))
+    os.close(fd)
+    print("%d bytes written to slot %d as %s" % (len(data), args.slot, args.name))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,267 @@
+/*
+ * simuart - runs the firmware ELF inside simavr and attaches USART0
+ * to a pseudo-terminal, so host tools can talk to the simulated board
+ * exactly like to the real one.
+ *
+ * Usage: simuart [-m mcu] [-f freq] [-l link] [-n] firmware.elf
+ *      -m  MCU name, atmega32 by default
+ *      -f  CPU frequency in Hz, 16000000 by default
+ *      -l  path of a symlink to be created to the pty slave,
+ *          /tmp/simuart by default
+ *      -n  do not throttle simulation to the wall clock
+ *
+ * By default the simulation is kept in sync with the wall clock, so
+ * latencies measured on the host side are the same as on the real
+ * board (as long as the host can simulate faster than real time).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <termios.h>
+#include <pty.h>
+
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_irq.h"
+#include "avr_uart.h"
+
+#define SIMUART_DEFAULT_MCU "atmega32"
+#define SIMUART_DEFAULT_FREQ 16000000UL
+#define SIMUART_DEFAULT_LINK "/tmp/simuart"
+
+/* How often (in simulated microseconds) pty is polled and clocks are synced */
+#define SIMUART_SYNC_PERIOD_US 250u
+
+#define SIMUART_FIFO_SIZE 4096u
+
+static volatile sig_atomic_t SIMUART_stop = 0;
+
+static int SIMUART_ptyMaster = -1;
+static uint8_t SIMUART_xon = 1u;
+
+static uint8_t SIMUART_fifo[SIMUART_FIFO_SIZE];
+static uint32_t SIMUART_fifoReadPos = 0u;
+static uint32_t SIMUART_fifoWritePos = 0u;
+
+static void SIMUART_SignalHandler(int sig)
+{
+    (void)sig;
+    SIMUART_stop = 1;
+}
+
+static uint64_t SIMUART_NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec;
+}
+
+/* Byte transmitted by the firmware - forward it to the host */
+static void SIMUART_OutputHook(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+    uint8_t ch = (uint8_t)value;
+    (void)irq;
+    (void)param;
+    if(write(SIMUART_ptyMaster, &ch, 1) < 0)
+    {
+        /* Host does not read, nothing we can do */
+    }
+}
+
+static void SIMUART_XonHook(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+    (void)irq;
+    (void)value;
+    (void)param;
+    SIMUART_xon = 1u;
+}
+
+static void SIMUART_XoffHook(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+    (void)irq;
+    (void)value;
+    (void)param;
+    SIMUART_xon = 0u;
+}
+
+static void SIMUART_PollHost(void)
+{
+    uint8_t tmpBuffer[256];
+    ssize_t length = 0;
+    ssize_t idx = 0;
+
+    length = read(SIMUART_ptyMaster, tmpBuffer, sizeof(tmpBuffer));
+    for(idx = 0; idx < length; idx++)
+    {
+        if( ((SIMUART_fifoWritePos + 1u) % SIMUART_FIFO_SIZE) != SIMUART_fifoReadPos )
+        {
+            SIMUART_fifo[SIMUART_fifoWritePos] = tmpBuffer[idx];
+            SIMUART_fifoWritePos = (SIMUART_fifoWritePos + 1u) % SIMUART_FIFO_SIZE;
+        }
+    }
+}
+
+static void SIMUART_FeedAvr(avr_irq_t *inputIrq)
+{
+    /* simavr UART has its own input FIFO, it tells us when it is full */
+    while( (SIMUART_xon != 0u) && (SIMUART_fifoReadPos != SIMUART_fifoWritePos) )
+    {
+        avr_raise_irq(inputIrq, SIMUART_fifo[SIMUART_fifoReadPos]);
+        SIMUART_fifoReadPos = (SIMUART_fifoReadPos + 1u) % SIMUART_FIFO_SIZE;
+    }
+}
+
+static int SIMUART_OpenPty(const char *linkPath)
+{
+    int slave = -1;
+    char slaveName[256];
+    struct termios tio;
+
+    if(openpty(&SIMUART_ptyMaster, &slave, slaveName, NULL, NULL) != 0)
+    {
+        perror("openpty");
+        return -1;
+    }
+    /* Raw mode both sides, no echo and no line discipline */
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+    tcgetattr(SIMUART_ptyMaster, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(SIMUART_ptyMaster, TCSANOW, &tio);
+    fcntl(SIMUART_ptyMaster, F_SETFL, fcntl(SIMUART_ptyMaster, F_GETFL) | O_NONBLOCK);
+
+    unlink(linkPath);
+    if(symlink(slaveName, linkPath) != 0)
+    {
+        perror("symlink");
+        return -1;
+    }
+    printf("simuart: USART0 is on %s (%s)\n", linkPath, slaveName);
+    fflush(stdout);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *mcuName = SIMUART_DEFAULT_MCU;
+    const char *linkPath = SIMUART_DEFAULT_LINK;
+    unsigned long frequency = SIMUART_DEFAULT_FREQ;
+    uint8_t realTime = 1u;
+    elf_firmware_t firmware;
+    avr_t *avr = NULL;
+    avr_irq_t *inputIrq = NULL;
+    uint32_t uartFlags = 0u;
+    avr_cycle_count_t syncPeriod = 0u;
+    avr_cycle_count_t nextSync = 0u;
+    uint64_t startNs = 0u;
+    uint64_t simNs = 0u;
+    uint64_t wallNs = 0u;
+    struct timespec pause;
+    int state = cpu_Running;
+    int opt = 0;
+
+    while( (opt = getopt(argc, argv, "m:f:l:n")) != -1 )
+    {
+        switch(opt)
+        {
+        case 'm':
+            mcuName = optarg;
+            break;
+        case 'f':
+            frequency = strtoul(optarg, NULL, 0);
+            break;
+        case 'l':
+            linkPath = optarg;
+            break;
+        case 'n':
+            realTime = 0u;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-m mcu] [-f freq] [-l link] [-n] firmware.elf\n", argv[0]);
+            return 1;
+        }
+    }
+    if(optind >= argc)
+    {
+        fprintf(stderr, "usage: %s [-m mcu] [-f freq] [-l link] [-n] firmware.elf\n", argv[0]);
+        return 1;
+    }
+
+    memset(&firmware, 0, sizeof(firmware));
+    if(elf_read_firmware(argv[optind], &firmware) != 0)
+    {
+        fprintf(stderr, "simuart: can not read %s\n", argv[optind]);
+        return 1;
+    }
+    avr = avr_make_mcu_by_name(mcuName);
+    if(avr == NULL)
+    {
+        fprintf(stderr, "simuart: unknown MCU %s\n", mcuName);
+        return 1;
+    }
+    avr_init(avr);
+    avr_load_firmware(avr, &firmware);
+    avr->frequency = frequency;
+
+    /* Do not let simavr print UART traffic to its own stdout */
+    avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &uartFlags);
+    uartFlags &= ~AVR_UART_FLAG_STDIO;
+    avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &uartFlags);
+
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT), SIMUART_OutputHook, NULL);
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUT_XON), SIMUART_XonHook, NULL);
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUT_XOFF), SIMUART_XoffHook, NULL);
+    inputIrq = avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT);
+
+    if(SIMUART_OpenPty(linkPath) != 0)
+    {
+        return 1;
+    }
+
+    signal(SIGINT, SIMUART_SignalHandler);
+    signal(SIGTERM, SIMUART_SignalHandler);
+
+    syncPeriod = ((avr_cycle_count_t)frequency * SIMUART_SYNC_PERIOD_US) / 1000000u;
+    nextSync = syncPeriod;
+    startNs = SIMUART_NowNs();
+
+    while( (SIMUART_stop == 0) && (state != cpu_Done) && (state != cpu_Crashed) )
+    {
+        state = avr_run(avr);
+
+        if(avr->cycle >= nextSync)
+        {
+            nextSync = avr->cycle + syncPeriod;
+            SIMUART_PollHost();
+            SIMUART_FeedAvr(inputIrq);
+
+            if(realTime != 0u)
+            {
+                /* Sleep while simulation is ahead of the wall clock */
+                simNs = (avr->cycle * 1000000000ull) / frequency;
+                wallNs = SIMUART_NowNs() - startNs;
+                if(simNs > wallNs)
+                {
+                    pause.tv_sec = (time_t)((simNs - wallNs) / 1000000000ull);
+                    pause.tv_nsec = (long)((simNs - wallNs) % 1000000000ull);
+                    nanosleep(&pause, NULL);
+                }
+            }
+        }
+    }
+
+    unlink(linkPath);
+    if(state == cpu_Crashed)
+    {
+        fprintf(stderr, "simuart: firmware crashed at PC 0x%04x\n", avr->pc);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""
+Decoder of ADC telemetry frames sent by the board on channel 1.
+
+Frame body (see src/telemetry/telemetry.h):
+    byte 0   bit 7 keyframe flag, bits 0-6 sequence number
+    byte 1   number of channels
+    then samples, a zigzag varint delta per channel each.
+A keyframe starts from zero, a delta frame continues from the last sample
+of the previous frame. When a frame is lost (sequence gap) samples are
+dropped until the next keyframe.
+
+Telemetry is turned on with the tlm1 command for the run and turned off
+with tlm0 afterwards, unless --keep is given.
+
+Prints decoded samples (or only statistics with --quiet) and compares the
+bytes on the wire with the same samples sent as hex-ASCII frames.
+
+Example:
+    tlmdecode.py --port /tmp/simuart --duration 10
+"""
+import argparse
+import os
+import sys
+import time
+
+from uartbench import FrameParser, drain, make_frame, open_port
+
+CHANNEL_TLM = 1
+KEYFRAME_FLAG = 0x80
+SEQUENCE_MASK = 0x7F
+HEADER_LENGTH = 2
+# ASK + channel + length + END\n
+FRAME_OVERHEAD = 3 + 1 + 2 + 4
+HEX_DIGITS_PER_VALUE = 4
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def read_varint(body, pos):
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(body):
+            raise ValueError("truncated varint")
+        byte = body[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+class TelemetryDecoder:
+    def __init__(self):
+        self.previous = None
+        self.sequence = None
+        self.synced = False
+        self.lost_frames = 0
+        self.broken_frames = 0
+
+    def decode(self, body):
+        """Returns list of samples (lists of channel values) of one frame."""
+        if len(body) < HEADER_LENGTH:
+            self.broken_frames += 1
+            return []
+        keyframe = bool(body[0] & KEYFRAME_FLAG)
+        sequence = body[0] & SEQUENCE_MASK
+        channels = body[1]
+        if self.sequence is not None and sequence != ((self.sequence + 1) & SEQUENCE_MASK):
+            self.lost_frames += (sequence - self.sequence - 1) & SEQUENCE_MASK
+            self.synced = False
+        self.sequence = sequence
+        if keyframe:
+            self.previous = [0] * channels
+            self.synced = True
+        if not self.synced or self.previous is None or len(self.previous) != channels:
+            return []
+        samples = []
+        pos = HEADER_LENGTH
+        try:
+            while pos < len(body):
+                sample = []
+                for idx in range(channels):
+                    delta, pos = read_varint(body, pos)
+                    self.previous[idx] = (self.previous[idx] + unzigzag(delta)) & 0xFFFF
+                    sample.append(self.previous[idx])
+                samples.append(sample)
+        except ValueError:
+            self.broken_frames += 1
+            self.synced = False
+        return samples
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--port", default="/tmp/simuart", help="serial port or pty path")
+    ap.add_argument("--baud", type=int, default=None, help="baud rate for real serial ports")
+    ap.add_argument("--duration", type=float, default=10.0, help="seconds to listen")
+    ap.add_argument("--quiet", action="store_true", help="print statistics only")
+    ap.add_argument("--keep", action="store_true", help="leave telemetry on after the run")
+    args = ap.parse_args()
+
+    fd = open_port(args.port, args.baud)
+    parser = FrameParser()
+    decoder = TelemetryDecoder()
+    wire_bytes = 0
+    values = 0
+    samples_total = 0
+    os.write(fd, make_frame(b"tlm1"))
+    end = time.monotonic() + args.duration
+    while time.monotonic() < end:
+        for channel, body in drain(fd, parser, 0.01):
+            if channel != CHANNEL_TLM:
+                continue
+            wire_bytes += FRAME_OVERHEAD + len(body)
+            for sample in decoder.decode(body):
+                samples_total += 1
+                values += len(sample)
+                if not args.quiet:
+                    print(" ".join("%4d" % value for value in sample))
+    if not args.keep:
+        os.write(fd, make_frame(b"tlm0"))
+    # The same samples as one hex-ASCII frame per sample
+    hex_bytes = samples_total * FRAME_OVERHEAD + values * HEX_DIGITS_PER_VALUE
+    print("samples: %d, frames lost: %d, broken: %d" % (samples_total, decoder.lost_frames, decoder.broken_frames))
+    if wire_bytes:
+        print("telemetry bytes: %d, as hex-ASCII frames: %d, ratio %.2fx" % (
+            wire_bytes, hex_bytes, float(hex_bytes) / wire_bytes))
+    sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,275 @@
+#!/usr/bin/env python3
+"""
+Load generator and latency benchmark for the ASK...END command protocol.
+
+Sends a configurable mix of commands (led/lcd/bip/old/mot) at increasing
+rates to a serial port or pty (see simuart.c) and reports, for every rate,
+the achieved command throughput, p50/p99 round-trip latency and the number
+of dropped (never answered) and unexpected (extra or broken) frames.
+
+Frames sent by the board carry a virtual channel digit after ASK; only
+frames of the command channel (0) are responses, telemetry and log frames
+are counted separately.
+
+Responses carry no request id, so they are matched to requests in FIFO
+order; requests that are not answered within --timeout are counted as
+dropped and removed from the queue before the next response is matched.
+
+Example:
+    uartbench.py --port /tmp/simuart --rates 10,25,50,100 --duration 5 \
+                 --mix led=4,lcd=2,bip=1,old=1,mot=1 --json result.json
+"""
+import argparse
+import json
+import os
+import random
+import select
+import sys
+import termios
+import time
+import tty
+
+START_SEQ = b"ASK"
+STOP_SEQ = b"END\n"
+LENGTH_OF_BODY_LENGTH = 2
+CHANNEL_ID_LENGTH = 1
+CHANNEL_CMD = 0
+
+# Command bodies for every command of the mix. Each entry is a list of
+# bodies to pick from, all of them are valid and harmless on the board.
+COMMAND_BODIES = {
+    "led": [b"led00", b"led01", b"led10", b"led11", b"led20", b"led21"],
+    "lcd": [b"lcd0E42", b"lcd0E--", b"lcd1E42", b"lcd1E--"],
+    "bip": [b"bip1"],
+    "old": [b"old20AF", b"old20A6"],
+    "mot": [b"mot00010", b"mot10010"],
+    "bat": [b"bat05led0005led1005led20", b"bat05led0105led1105led21"],
+}
+
+
+COALESCED_TAG = b"MRF"
+ACCEPTED_TAG = b"_ACC_"
+EVENT_TAG = b"_EVT_"
+RECORD_NAME_LENGTH = 3
+
+
+def split_records(body):
+    """Splits a coalesced MRF frame body into (name, status, data) records."""
+    records = []
+    pos = len(COALESCED_TAG)
+    while pos + RECORD_NAME_LENGTH + 4 <= len(body):
+        name = body[pos:pos + RECORD_NAME_LENGTH]
+        status = int(body[pos + RECORD_NAME_LENGTH:pos + RECORD_NAME_LENGTH + 2], 16)
+        length = int(body[pos + RECORD_NAME_LENGTH + 2:pos + RECORD_NAME_LENGTH + 4], 16)
+        pos += RECORD_NAME_LENGTH + 4
+        records.append((name, status, body[pos:pos + length]))
+        pos += length
+    return records
+
+
+def responses(frame):
+    """Returns list of 'is OK' flags, one per command answered by the frame.
+
+    Long-running commands are answered _ACC_<job id>, their completion
+    events (_EVT_...) come later and answer no request."""
+    if frame.startswith(EVENT_TAG):
+        return []
+    if frame.startswith(COALESCED_TAG):
+        return [status == 0 for _, status, _ in split_records(frame)]
+    return [frame == b"_OK_" or frame.startswith(ACCEPTED_TAG)]
+
+
+def make_frame(body):
+    return START_SEQ + ("%02X" % len(body)).encode() + body + STOP_SEQ
+
+
+class FrameParser:
+    """Incremental parser of ASK<channel><len><body>END\\n frames sent by the board."""
+
+    def __init__(self):
+        self.buffer = b""
+        self.broken = 0
+
+    def feed(self, data):
+        frames = []
+        self.buffer += data
+        while True:
+            start = self.buffer.find(START_SEQ)
+            if start < 0:
+                # Keep a possible partial start sequence only
+                self.buffer = self.buffer[-(len(START_SEQ) - 1):]
+                break
+            if start > 0:
+                self.broken += 1
+                self.buffer = self.buffer[start:]
+            header = len(START_SEQ) + CHANNEL_ID_LENGTH + LENGTH_OF_BODY_LENGTH
+            if len(self.buffer) < header:
+                break
+            try:
+                channel = int(self.buffer[len(START_SEQ):len(START_SEQ) + CHANNEL_ID_LENGTH], 16)
+                length = int(self.buffer[len(START_SEQ) + CHANNEL_ID_LENGTH:header], 16)
+            except ValueError:
+                self.broken += 1
+                self.buffer = self.buffer[len(START_SEQ):]
+                continue
+            end = header + length + len(STOP_SEQ)
+            if len(self.buffer) < end:
+                break
+            if self.buffer[header + length:end] != STOP_SEQ:
+                self.broken += 1
+                self.buffer = self.buffer[len(START_SEQ):]
+                continue
+            frames.append((channel, self.buffer[header:header + length]))
+            self.buffer = self.buffer[end:]
+        return frames
+
+
+def open_port(path, baud):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+    tty.setraw(fd)
+    if baud is not None:
+        attrs = termios.tcgetattr(fd)
+        speed = getattr(termios, "B%d" % baud, None)
+        if speed is not None:
+            attrs[4] = attrs[5] = speed
+            termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+
+def parse_mix(text):
+    mix = []
+    for item in text.split(","):
+        name, _, weight = item.partition("=")
+        if name not in COMMAND_BODIES:
+            raise SystemExit("unknown command in mix: %s" % name)
+        mix.append((name, int(weight or "1")))
+    return mix
+
+
+def percentile(values, p):
+    if not values:
+        return float("nan")
+    ordered = sorted(values)
+    idx = min(len(ordered) - 1, int(round((p / 100.0) * (len(ordered) - 1))))
+    return ordered[idx]
+
+
+def drain(fd, parser, timeout):
+    ready, _, _ = select.select([fd], [], [], timeout)
+    if not ready:
+        return []
+    try:
+        data = os.read(fd, 4096)
+    except BlockingIOError:
+        return []
+    return parser.feed(data)
+
+
+def run_rate(fd, rate, duration, mix, timeout, rng):
+    names = [name for name, _ in mix]
+    weights = [weight for _, weight in mix]
+    parser = FrameParser()
+    pending = []
+    latencies = []
+    sent = 0
+    answered = 0
+    dropped = 0
+    errors = 0
+    unexpected = 0
+    other_channels = 0
+
+    period = 1.0 / rate
+    begin = time.monotonic()
+    next_send = begin
+    stop_send = begin + duration
+
+    while True:
+        now = time.monotonic()
+        if now >= stop_send and not pending:
+            break
+        if now >= stop_send + timeout:
+            break
+        if now >= next_send and now < stop_send:
+            name = rng.choices(names, weights)[0]
+            body = rng.choice(COMMAND_BODIES[name])
+            os.write(fd, make_frame(body))
+            pending.append(time.monotonic())
+            sent += 1
+            next_send += period
+        wait = max(0.0, min(next_send, stop_send + timeout) - time.monotonic())
+        for channel, frame in drain(fd, parser, min(wait, 0.001)):
+            if channel != CHANNEL_CMD:
+                other_channels += 1
+                continue
+            now = time.monotonic()
+            while pending and (now - pending[0]) > timeout:
+                pending.pop(0)
+                dropped += 1
+            for ok in responses(frame):
+                if not pending:
+                    unexpected += 1
+                    continue
+                latencies.append(now - pending.pop(0))
+                answered += 1
+                if not ok:
+                    errors += 1
+        now = time.monotonic()
+        while pending and (now - pending[0]) > timeout:
+            pending.pop(0)
+            dropped += 1
+
+    dropped += len(pending)
+    elapsed = time.monotonic() - begin
+    return {
+        "rate": rate,
+        "sent": sent,
+        "answered": answered,
+        "commands_per_s": answered / elapsed if elapsed > 0 else 0.0,
+        "p50_ms": percentile(latencies, 50) * 1000.0,
+        "p99_ms": percentile(latencies, 99) * 1000.0,
+        "dropped": dropped,
+        "error_responses": errors,
+        "unexpected_frames": unexpected + parser.broken,
+        "other_channel_frames": other_channels,
+    }
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--port", default="/tmp/simuart", help="serial port or pty path")
+    ap.add_argument("--baud", type=int, default=None, help="baud rate for real serial ports")
+    ap.add_argument("--mix", default="led=4,lcd=2,bip=1,old=1,mot=1", help="command weights")
+    ap.add_argument("--rates", default="10,25,50,100,200", help="comma separated commands/s")
+    ap.add_argument("--duration", type=float, default=5.0, help="seconds per rate step")
+    ap.add_argument("--timeout", type=float, default=0.5, help="seconds until a command is dropped")
+    ap.add_argument("--settle", type=float, default=0.5, help="idle seconds between steps")
+    ap.add_argument("--seed", type=int, default=1, help="random seed of the command mix")
+    ap.add_argument("--json", help="write results to this file")
+    args = ap.parse_args()
+
+    mix = parse_mix(args.mix)
+    rates = [float(r) for r in args.rates.split(",")]
+    rng = random.Random(args.seed)
+
+    fd = open_port(args.port, args.baud)
+    results = []
+    print("%8s %8s %8s %10s %9s %9s %8s %8s %8s" % (
+        "rate", "sent", "answered", "cmd/s", "p50 ms", "p99 ms", "dropped", "errors", "extra"))
+    for rate in rates:
+        time.sleep(args.settle)
+        drain(fd, FrameParser(), 0.0)
+        res = run_rate(fd, rate, args.duration, mix, args.timeout, rng)
+        results.append(res)
+        print("%8.1f %8d %8d %10.1f %9.2f %9.2f %8d %8d %8d" % (
+            res["rate"], res["sent"], res["answered"], res["commands_per_s"], res["p50_ms"],
+            res["p99_ms"], res["dropped"], res["error_responses"], res["unexpected_frames"]))
+        sys.stdout.flush()
+    os.close(fd)
+
+    if args.json:
+        with open(args.json, "w") as out:
+            json.dump({"mix": args.mix, "duration": args.duration, "results": results}, out, indent=2)
+
+
+if __name__ == "__main__":
+    main()